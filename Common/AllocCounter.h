@@ -0,0 +1,11 @@
+#pragma once
+#include <stdint.h>
+
+// Counts calls to the global operator new (AllocCounter.cpp replaces it, so
+// link that file into a program to count its heap allocations). The count is
+// one relaxed atomic add per allocation.
+class AllocCounter {
+public:
+    // Allocations since program start
+    static uint64_t GetCount();
+};
@@ -0,0 +1,122 @@
+#include "Arena.h"
+#include <new>
+
+LinearArena::LinearArena(size_t blockSize) {
+    mCurrent = 0;
+    mOffset = 0;
+    mBlockSize = blockSize;
+}
+
+LinearArena::~LinearArena() {
+    Release();
+}
+
+void* LinearArena::Allocate(size_t size, size_t align) {
+    while (mCurrent < mBlocks.size()) {
+        Block& block = mBlocks[mCurrent];
+        size_t start = (mOffset + align - 1) & ~(align - 1);
+        if (start + size <= block.size) {
+            mOffset = start + size;
+            return block.data + start;
+        }
+        // doesn't fit: move on to the next kept block
+        mCurrent++;
+        mOffset = 0;
+    }
+    // out of blocks, grow (oversized requests get a block of their own)
+    size_t blockSize = size + align > mBlockSize ? size + align : mBlockSize;
+    Block block = {static_cast<char*>(::operator new(blockSize)), blockSize};
+    mBlocks.push_back(block);
+    mCurrent = mBlocks.size() - 1;
+    size_t start = (reinterpret_cast<size_t>(block.data) + align - 1) & ~(align - 1);
+    start -= reinterpret_cast<size_t>(block.data);
+    mOffset = start + size;
+    return block.data + start;
+}
+
+void LinearArena::Reset() {
+    mCurrent = 0;
+    mOffset = 0;
+}
+
+void LinearArena::Release() {
+    for (Block& block : mBlocks) {
+        ::operator delete(block.data);
+    }
+    mBlocks.clear();
+    Reset();
+}
+
+size_t LinearArena::GetUsed() const {
+    size_t used = mOffset;
+    for (size_t i = 0; i < mCurrent && i < mBlocks.size(); i++) {
+        used += mBlocks[i].size;
+    }
+    return used;
+}
+
+size_t LinearArena::GetCapacity() const {
+    size_t capacity = 0;
+    for (const Block& block : mBlocks) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+PoolArena::PoolArena() : mArena(256 * 1024) {
+    for (size_t i = 0; i < kClassCount; i++) {
+        mFreeLists[i] = nullptr;
+    }
+    mLive = 0;
+}
+
+void* PoolArena::Allocate(size_t size) {
+    mLive++;
+    size_t sizeClass = (size + kGranularity - 1) / kGranularity;
+    if (sizeClass == 0) {
+        sizeClass = 1;
+    }
+    if (sizeClass > kClassCount) {
+        return ::operator new(size);
+    }
+    FreeNode* node = mFreeLists[sizeClass - 1];
+    if (node) {
+        mFreeLists[sizeClass - 1] = node->next;
+        return node;
+    }
+    return mArena.Allocate(sizeClass * kGranularity, kGranularity);
+}
+
+void PoolArena::Free(void* ptr, size_t size) {
+    if (!ptr) {
+        return;
+    }
+    mLive--;
+    size_t sizeClass = (size + kGranularity - 1) / kGranularity;
+    if (sizeClass == 0) {
+        sizeClass = 1;
+    }
+    if (sizeClass > kClassCount) {
+        ::operator delete(ptr);
+        return;
+    }
+    FreeNode* node = static_cast<FreeNode*>(ptr);
+    node->next = mFreeLists[sizeClass - 1];
+    mFreeLists[sizeClass - 1] = node;
+}
+
+bool PoolArena::Release() {
+    if (mLive != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < kClassCount; i++) {
+        mFreeLists[i] = nullptr;
+    }
+    mArena.Release();
+    return true;
+}
+
+PoolArena& GetLevelPool() {
+    static PoolArena pool;
+    return pool;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <stddef.h>
+#include <vector>
+
+// Linear (bump) allocator: Allocate moves an offset forward, Reset frees
+// everything at once. Memory comes in blocks that are kept across resets, so
+// once the arena has grown to its high-water mark it never touches the heap.
+// Nothing allocated here has its destructor run (use it for trivial types).
+class LinearArena {
+public:
+    LinearArena(size_t blockSize = 64 * 1024);
+    ~LinearArena();
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    void* Allocate(size_t size, size_t align = alignof(max_align_t));
+    template <typename T>
+    T* AllocateArray(size_t count) {
+        return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+    }
+    // Forgets every allocation (blocks are kept for reuse)
+    void Reset();
+    // Returns every block to the heap
+    void Release();
+
+    size_t GetUsed() const;
+    size_t GetCapacity() const;
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+    std::vector<Block> mBlocks;
+    // block being bumped and the offset into it
+    size_t mCurrent;
+    size_t mOffset;
+    size_t mBlockSize;
+};
+
+// Objects that die one at a time (actors, components) on top of a LinearArena:
+// sizes are rounded up to 16-byte classes and freed blocks go on the class's
+// free list, so steady-state churn reuses memory instead of calling new/delete.
+// Release drops the whole level in one shot once every object is destroyed.
+// Not thread-safe; allocate and free from the main thread.
+class PoolArena {
+public:
+    PoolArena();
+    void* Allocate(size_t size);
+    // size must be the size passed to Allocate (sized operator delete gives it)
+    void Free(void* ptr, size_t size);
+    // Frees all memory if no object is live (returns false and keeps it otherwise)
+    bool Release();
+    int GetLiveCount() const { return mLive; }
+    size_t GetCapacity() const { return mArena.GetCapacity(); }
+
+private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+    static const size_t kGranularity = 16;
+    // classes cover up to 1KB, bigger objects go straight to the heap
+    static const size_t kClassCount = 64;
+
+    LinearArena mArena;
+    FreeNode* mFreeLists[kClassCount];
+    int mLive;
+};
+
+// STL allocator adapter over a process-wide PoolArena, for containers owned by
+// pool-allocated objects (e.g. an actor's component list)
+PoolArena& GetLevelPool();
+
+template <typename T>
+struct LevelAllocator {
+    typedef T value_type;
+    LevelAllocator() {}
+    template <typename U>
+    LevelAllocator(const LevelAllocator<U>&) {}
+    T* allocate(size_t count) { return static_cast<T*>(GetLevelPool().Allocate(count * sizeof(T))); }
+    void deallocate(T* ptr, size_t count) { GetLevelPool().Free(ptr, count * sizeof(T)); }
+    template <typename U>
+    bool operator==(const LevelAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const LevelAllocator<U>&) const { return false; }
+};
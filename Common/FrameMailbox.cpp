@@ -0,0 +1,74 @@
+#include "FrameMailbox.h"
+
+FrameMailbox::FrameMailbox() {
+    Reset();
+}
+
+void FrameMailbox::Reset() {
+    mWrite = 0;
+    mShared.store(1, std::memory_order_relaxed);
+    mRead = 2;
+    mHasFrame = false;
+    mPublishedCount.store(0, std::memory_order_relaxed);
+    mDroppedCount.store(0, std::memory_order_relaxed);
+    mPresentedCount = 0;
+    mDuplicatedCount = 0;
+    mLastLatencyMs = 0.0;
+    mTotalLatencyMs = 0.0;
+    mMaxLatencyMs = 0.0;
+}
+
+int FrameMailbox::Publish() {
+    mPublishTime[mWrite] = Clock::now();
+    // release: the frame's contents are visible to whoever exchanges it out
+    unsigned previous = mShared.exchange(static_cast<unsigned>(mWrite) | kFresh, std::memory_order_acq_rel);
+    if (previous & kFresh) {
+        mDroppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    mWrite = static_cast<int>(previous & kIndexMask);
+    mPublishedCount.fetch_add(1, std::memory_order_relaxed);
+    {
+        // taking the lock orders this with a consumer about to wait
+        std::lock_guard<std::mutex> lock(mMutex);
+    }
+    mPublished.notify_one();
+    return mWrite;
+}
+
+int FrameMailbox::Acquire(double timeoutMs) {
+    if (!(mShared.load(std::memory_order_acquire) & kFresh)) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        bool fresh = mPublished.wait_for(lock, std::chrono::duration<double, std::milli>(timeoutMs), [this]() {
+            return (mShared.load(std::memory_order_acquire) & kFresh) != 0;
+        });
+        if (!fresh) {
+            if (mHasFrame) {
+                mDuplicatedCount++;
+            }
+            return -1;
+        }
+    }
+    // only the consumer clears kFresh, so the frame is still there
+    mRead = static_cast<int>(mShared.exchange(static_cast<unsigned>(mRead), std::memory_order_acq_rel) & kIndexMask);
+    mHasFrame = true;
+
+    mLastLatencyMs = std::chrono::duration<double, std::milli>(Clock::now() - mPublishTime[mRead]).count();
+    mTotalLatencyMs += mLastLatencyMs;
+    if (mLastLatencyMs > mMaxLatencyMs) {
+        mMaxLatencyMs = mLastLatencyMs;
+    }
+    mPresentedCount++;
+    return mRead;
+}
+
+FrameMailboxStats FrameMailbox::GetStats() const {
+    FrameMailboxStats stats;
+    stats.published = mPublishedCount.load(std::memory_order_relaxed);
+    stats.presented = mPresentedCount;
+    stats.dropped = mDroppedCount.load(std::memory_order_relaxed);
+    stats.duplicated = mDuplicatedCount;
+    stats.lastLatencyMs = mLastLatencyMs;
+    stats.averageLatencyMs = mPresentedCount > 0 ? mTotalLatencyMs / mPresentedCount : 0.0;
+    stats.maxLatencyMs = mMaxLatencyMs;
+    return stats;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+
+// Hand-over metrics since the last Reset (latencies in milliseconds)
+struct FrameMailboxStats {
+    uint64_t published;      // frames completed by the producer
+    uint64_t presented;      // new frames picked up by the consumer
+    uint64_t dropped;        // frames replaced by a newer one before the consumer got to them
+    uint64_t duplicated;     // waits that found nothing new (the screen showed a frame again)
+    double lastLatencyMs;    // publish to pick-up of the last new frame
+    double averageLatencyMs;
+    double maxLatencyMs;
+};
+
+// Hands complete frames from one producer thread to one consumer thread
+// through three buffers owned by the caller (indices 0-2): one being filled,
+// one being drawn and one holding the newest complete frame. Publishing swaps
+// the filled buffer with the newest one, picking up swaps the drawn one with
+// it (a single atomic exchange each), so the producer never waits for the
+// consumer and the consumer always gets the most recent frame.
+class FrameMailbox {
+public:
+    FrameMailbox();
+    // Forget every frame and the stats (neither thread may be using it)
+    void Reset();
+
+    // Producer: the buffer to fill next
+    int GetWriteIndex() const { return mWrite; }
+    // Producer: hands the filled buffer over (replacing a newest frame the
+    // consumer hasn't picked up yet) and returns the next buffer to fill
+    int Publish();
+
+    // Consumer: waits up to timeoutMs for a frame newer than the last one and
+    // returns its buffer, which stays the consumer's until the next call.
+    // Returns -1 on timeout (after the first frame this counts as a duplicate).
+    int Acquire(double timeoutMs);
+    // Consumer (or any thread once the producer has stopped)
+    FrameMailboxStats GetStats() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+    // set on the shared index while it holds a frame nobody picked up yet
+    static const unsigned kFresh = 4;
+    static const unsigned kIndexMask = 3;
+
+    // index of the newest complete frame (| kFresh if not picked up yet)
+    std::atomic<unsigned> mShared;
+    // producer's buffer
+    int mWrite;
+    // consumer's buffer (holds a frame once mHasFrame is set)
+    int mRead;
+    bool mHasFrame;
+    // when each buffer was published (written before the exchange that hands it over)
+    Clock::time_point mPublishTime[3];
+    // lets the consumer sleep until a frame is published
+    std::mutex mMutex;
+    std::condition_variable mPublished;
+
+    // producer side
+    std::atomic<uint64_t> mPublishedCount;
+    std::atomic<uint64_t> mDroppedCount;
+    // consumer side
+    uint64_t mPresentedCount;
+    uint64_t mDuplicatedCount;
+    double mLastLatencyMs;
+    double mTotalLatencyMs;
+    double mMaxLatencyMs;
+};
@@ -0,0 +1,152 @@
+#include "JobSystem.h"
+
+// set once by each worker thread
+static thread_local int sThreadIndex = 0;
+
+int JobSystem::GetThreadIndex() {
+    return sThreadIndex;
+}
+
+void JobSystem::WorkQueue::Push(const Job& job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (tail == static_cast<int>(jobs.size())) {
+        if (head > 0) { // slide live jobs back to the front
+            for (int i = head; i < tail; i++) {
+                jobs[i - head] = jobs[i];
+            }
+            tail -= head;
+            head = 0;
+        } else { // only grows until it fits the largest loop
+            jobs.resize(jobs.empty() ? 64 : jobs.size() * 2);
+        }
+    }
+    jobs[tail++] = job;
+}
+
+bool JobSystem::WorkQueue::Pop(Job& job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (head == tail) {
+        return false;
+    }
+    job = jobs[--tail];
+    if (head == tail) {
+        head = tail = 0;
+    }
+    return true;
+}
+
+bool JobSystem::WorkQueue::Steal(Job& job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (head == tail) {
+        return false;
+    }
+    job = jobs[head++];
+    if (head == tail) {
+        head = tail = 0;
+    }
+    return true;
+}
+
+JobSystem::JobSystem(int threadCount) : mPendingJobs(0) {
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+        if (threadCount <= 0) {
+            threadCount = 1;
+        }
+    }
+    mSubmitCount = 0;
+    mQuit = false;
+
+    for (int i = 0; i < threadCount; i++) {
+        mQueues.push_back(new WorkQueue());
+    }
+    // thread 0 is whoever calls ParallelFor
+    for (int i = 1; i < threadCount; i++) {
+        mWorkers.emplace_back(&JobSystem::WorkerMain, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mQuit = true;
+    }
+    mWake.notify_all();
+    for (auto& worker : mWorkers) {
+        worker.join();
+    }
+    for (auto queue : mQueues) {
+        delete queue;
+    }
+}
+
+void JobSystem::ParallelFor(int count, int chunkSize, const std::function<void(int, int)>& fn) {
+    if (count <= 0) {
+        return;
+    }
+    if (chunkSize < 1) {
+        chunkSize = 1;
+    }
+    // nothing to share
+    if (mWorkers.empty() || count <= chunkSize) {
+        for (int begin = 0; begin < count; begin += chunkSize) {
+            fn(begin, begin + chunkSize < count ? begin + chunkSize : count);
+        }
+        return;
+    }
+
+    // deal chunks round-robin so every deque starts with a share of the work
+    int numChunks = (count + chunkSize - 1) / chunkSize;
+    mPendingJobs.fetch_add(numChunks);
+    int numQueues = static_cast<int>(mQueues.size());
+    for (int chunk = 0; chunk < numChunks; chunk++) {
+        int begin = chunk * chunkSize;
+        int end = begin + chunkSize < count ? begin + chunkSize : count;
+        mQueues[chunk % numQueues]->Push({&fn, begin, end});
+    }
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mSubmitCount++;
+    }
+    mWake.notify_all();
+
+    // help out until everything (including chunks other threads took) is done
+    while (mPendingJobs.load() > 0) {
+        if (!RunOne(0)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool JobSystem::RunOne(int index) {
+    Job job;
+    bool found = mQueues[index]->Pop(job);
+    int numQueues = static_cast<int>(mQueues.size());
+    for (int i = 1; !found && i < numQueues; i++) {
+        found = mQueues[(index + i) % numQueues]->Steal(job);
+    }
+    if (!found) {
+        return false;
+    }
+    (*job.fn)(job.begin, job.end);
+    mPendingJobs.fetch_sub(1);
+    return true;
+}
+
+void JobSystem::WorkerMain(int index) {
+    sThreadIndex = index;
+    unsigned seenSubmits = 0;
+    while (true) {
+        {
+            // sleep until a new loop is submitted
+            std::unique_lock<std::mutex> lock(mWakeMutex);
+            mWake.wait(lock, [&] { return mQuit || mSubmitCount != seenSubmits; });
+            if (mQuit) {
+                return;
+            }
+            seenSubmits = mSubmitCount;
+        }
+        while (RunOne(index)) {
+        }
+    }
+}
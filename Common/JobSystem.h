@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small worker pool for data-parallel loops.
+// Every thread (the caller counts as thread 0) owns a deque of jobs: the owner
+// pops from the back, idle threads steal from the front of other deques.
+class JobSystem {
+public:
+    // threadCount includes the calling thread (0 = one per hardware thread)
+    JobSystem(int threadCount = 0);
+    ~JobSystem();
+
+    int GetThreadCount() const { return static_cast<int>(mQueues.size()); }
+    // Index of the calling thread in its pool: 0 for the thread that calls
+    // ParallelFor (or any thread that isn't a worker), 1.. for workers
+    static int GetThreadIndex();
+
+    // Calls fn(begin, end) for consecutive chunks of [0, count) and returns once
+    // every chunk is done. Chunk boundaries only depend on chunkSize, so
+    // results don't change with the number of threads.
+    // Must only be called from one thread at a time (not from inside a job).
+    void ParallelFor(int count, int chunkSize, const std::function<void(int, int)>& fn);
+
+private:
+    struct Job {
+        const std::function<void(int, int)>* fn;
+        int begin;
+        int end;
+    };
+
+    // Ring of jobs guarded by a mutex; push/pop at the back, steal at the front
+    struct WorkQueue {
+        std::mutex mutex;
+        std::vector<Job> jobs;
+        int head = 0;
+        int tail = 0;
+
+        void Push(const Job& job);
+        bool Pop(Job& job);
+        bool Steal(Job& job);
+    };
+
+    void WorkerMain(int index);
+    // Runs one job from our own queue or steals one; false if all queues are empty
+    bool RunOne(int index);
+
+    std::vector<WorkQueue*> mQueues;
+    std::vector<std::thread> mWorkers;
+    // jobs pushed but not finished yet
+    std::atomic<int> mPendingJobs;
+    // wakes sleeping workers when a loop is submitted
+    std::mutex mWakeMutex;
+    std::condition_variable mWake;
+    unsigned mSubmitCount;
+    bool mQuit;
+};
@@ -0,0 +1,94 @@
+#pragma once
+#include <math.h>
+
+// 2D vector shared by both games. Stays an aggregate, so {x, y} initialization
+// and direct .x/.y access keep working; the operators are constexpr.
+struct Vector2 {
+    float x;
+    float y;
+
+    constexpr Vector2& operator+=(const Vector2& other) {
+        x += other.x;
+        y += other.y;
+        return *this;
+    }
+    constexpr Vector2& operator-=(const Vector2& other) {
+        x -= other.x;
+        y -= other.y;
+        return *this;
+    }
+    constexpr Vector2& operator*=(float scalar) {
+        x *= scalar;
+        y *= scalar;
+        return *this;
+    }
+};
+
+constexpr Vector2 operator+(const Vector2& a, const Vector2& b) {
+    return {a.x + b.x, a.y + b.y};
+}
+constexpr Vector2 operator-(const Vector2& a, const Vector2& b) {
+    return {a.x - b.x, a.y - b.y};
+}
+constexpr Vector2 operator-(const Vector2& v) {
+    return {-v.x, -v.y};
+}
+constexpr Vector2 operator*(const Vector2& v, float scalar) {
+    return {v.x * scalar, v.y * scalar};
+}
+constexpr Vector2 operator*(float scalar, const Vector2& v) {
+    return {v.x * scalar, v.y * scalar};
+}
+constexpr bool operator==(const Vector2& a, const Vector2& b) {
+    return a.x == b.x && a.y == b.y;
+}
+constexpr bool operator!=(const Vector2& a, const Vector2& b) {
+    return !(a == b);
+}
+constexpr float Dot(const Vector2& a, const Vector2& b) {
+    return a.x * b.x + a.y * b.y;
+}
+constexpr float LengthSq(const Vector2& v) {
+    return v.x * v.x + v.y * v.y;
+}
+inline float Length(const Vector2& v) {
+    return sqrtf(LengthSq(v));
+}
+// Zero vector stays zero
+inline Vector2 Normalize(const Vector2& v) {
+    float length = Length(v);
+    return length > 0.0f ? v * (1.0f / length) : v;
+}
+
+// 2D affine transform (rotation/scale in the 2x2 part, then translation):
+//   x' = m00 * x + m01 * y + tx
+//   y' = m10 * x + m11 * y + ty
+struct Matrix2D {
+    float m00, m01;
+    float m10, m11;
+    float tx, ty;
+
+    static constexpr Matrix2D Identity() { return {1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f}; }
+    // Scale, then rotate by the angle whose cosine/sine are given
+    // (counterclockwise on screen, where y points down), then translate
+    static constexpr Matrix2D FromCosSin(const Vector2& position, float cosine, float sine, float scale) {
+        return {cosine * scale, sine * scale, -sine * scale, cosine * scale, position.x, position.y};
+    }
+    static Matrix2D FromTransform(const Vector2& position, float rotation, float scale) {
+        return FromCosSin(position, cosf(rotation), sinf(rotation), scale);
+    }
+
+    constexpr Vector2 TransformPoint(const Vector2& p) const {
+        return {m00 * p.x + m01 * p.y + tx, m10 * p.x + m11 * p.y + ty};
+    }
+    // Ignores the translation
+    constexpr Vector2 TransformVector(const Vector2& v) const { return {m00 * v.x + m01 * v.y, m10 * v.x + m11 * v.y}; }
+    constexpr Vector2 GetTranslation() const { return {tx, ty}; }
+};
+
+// a * b applies b first, then a
+constexpr Matrix2D operator*(const Matrix2D& a, const Matrix2D& b) {
+    return {a.m00 * b.m00 + a.m01 * b.m10, a.m00 * b.m01 + a.m01 * b.m11,
+            a.m10 * b.m00 + a.m11 * b.m10, a.m10 * b.m01 + a.m11 * b.m11,
+            a.m00 * b.tx + a.m01 * b.ty + a.tx, a.m10 * b.tx + a.m11 * b.ty + a.ty};
+}
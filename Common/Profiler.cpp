@@ -0,0 +1,147 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <string>
+#include <stdio.h>
+#include <string.h>
+
+// Small id per thread for the trace (0 is whichever thread records first)
+static uint32_t CurrentThreadId() {
+    static std::atomic<uint32_t> nextId(0);
+    thread_local uint32_t id = nextId.fetch_add(1);
+    return id;
+}
+
+Profiler& Profiler::Get() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler() : mWriteIndex(0) {
+    // allocated once; events never allocate
+    mRing = new Slot[kRingSize];
+    for (uint64_t i = 0; i < kRingSize; i++) {
+        mRing[i].sequence.store(0, std::memory_order_relaxed);
+    }
+    mFrameCount = 0;
+    mFrameStartNs = NowNs();
+}
+
+uint64_t Profiler::NowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+void Profiler::Record(const char* name, uint64_t startNs, uint64_t endNs) {
+    uint64_t index = mWriteIndex.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = mRing[index & (kRingSize - 1)];
+    // mark the slot as being written so a reader doesn't take a half-written event
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.event = {name, startNs, endNs, CurrentThreadId()};
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::EndFrame() {
+    uint64_t now = NowNs();
+    mFrameTimes[mFrameCount % kFrameWindow] = static_cast<float>(now - mFrameStartNs) / 1e6f;
+    mFrameCount++;
+    mFrameStartNs = now;
+}
+
+void Profiler::Snapshot(std::vector<ProfileEvent>& events) {
+    uint64_t end = mWriteIndex.load(std::memory_order_acquire);
+    uint64_t begin = end > kRingSize ? end - kRingSize : 0;
+    events.clear();
+    events.reserve(static_cast<size_t>(end - begin));
+    for (uint64_t index = begin; index < end; index++) {
+        const Slot& slot = mRing[index & (kRingSize - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != index + 1) {
+            continue;
+        }
+        // a writer may wrap around onto this slot while we copy: keep the
+        // copy only if the sequence is still the same afterwards
+        ProfileEvent event = slot.event;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == index + 1) {
+            events.push_back(event);
+        }
+    }
+}
+
+void Profiler::WriteReports(const char* prefix) {
+    std::vector<ProfileEvent> events;
+    Snapshot(events);
+
+    char fileName[512];
+    snprintf(fileName, sizeof(fileName), "%s_trace.json", prefix);
+    WriteChromeTrace(fileName, events);
+    snprintf(fileName, sizeof(fileName), "%s_summary.log", prefix);
+    WriteSummary(fileName, events);
+}
+
+bool Profiler::WriteChromeTrace(const char* fileName, const std::vector<ProfileEvent>& events) {
+    FILE* file = fopen(fileName, "w");
+    if (!file) {
+        return false;
+    }
+    uint64_t origin = events.empty() ? 0 : events.front().startNs;
+    for (const ProfileEvent& event : events) {
+        origin = std::min(origin, event.startNs);
+    }
+
+    // complete ("X") events, timestamps in microseconds
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (size_t i = 0; i < events.size(); i++) {
+        const ProfileEvent& event = events[i];
+        fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+                event.name, event.threadId, (event.startNs - origin) / 1000.0,
+                (event.endNs - event.startNs) / 1000.0, i + 1 < events.size() ? "," : "");
+    }
+    fprintf(file, "]}\n");
+    fclose(file);
+    return true;
+}
+
+// p50/p99/max of a set of durations (ms), sorts in place
+static void Percentiles(std::vector<float>& times, float& p50, float& p99, float& max) {
+    p50 = p99 = max = 0.0f;
+    if (times.empty()) {
+        return;
+    }
+    std::sort(times.begin(), times.end());
+    p50 = times[times.size() / 2];
+    p99 = times[std::min(times.size() - 1, times.size() * 99 / 100)];
+    max = times.back();
+}
+
+bool Profiler::WriteSummary(const char* fileName, const std::vector<ProfileEvent>& events) {
+    FILE* file = fopen(fileName, "w");
+    if (!file) {
+        return false;
+    }
+
+    // std::min takes references, and kFrameWindow has no out-of-class definition
+    int window = kFrameWindow;
+    std::vector<float> frames(mFrameTimes, mFrameTimes + std::min(mFrameCount, window));
+    float p50, p99, max;
+    Percentiles(frames, p50, p99, max);
+    fprintf(file, "frames: %d total, last %d: p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+            mFrameCount, static_cast<int>(frames.size()), p50, p99, max);
+
+    // per marker, over whatever is still in the ring
+    std::map<std::string, std::vector<float>> byName;
+    for (const ProfileEvent& event : events) {
+        byName[event.name].push_back((event.endNs - event.startNs) / 1e6f);
+    }
+    fprintf(file, "%-32s %8s %10s %10s %10s\n", "marker", "count", "p50 ms", "p99 ms", "max ms");
+    for (auto& entry : byName) {
+        int count = static_cast<int>(entry.second.size());
+        Percentiles(entry.second, p50, p99, max);
+        fprintf(file, "%-32s %8d %10.3f %10.3f %10.3f\n", entry.first.c_str(), count, p50, p99, max);
+    }
+    fclose(file);
+    return true;
+}
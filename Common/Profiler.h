@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+
+// Build with -DPROFILING_ENABLED=1 to record markers. When it is 0 every
+// PROFILE_* macro expands to nothing, so markers cost nothing in normal builds.
+#ifndef PROFILING_ENABLED
+#define PROFILING_ENABLED 0
+#endif
+
+// One timed scope
+struct ProfileEvent {
+    const char* name; // must be a string literal (only the pointer is stored)
+    uint64_t startNs;
+    uint64_t endNs;
+    uint32_t threadId;
+};
+
+// Records scoped timing markers from any thread into a fixed-size ring buffer
+// (lock-free: writers claim slots with one atomic increment, old events are
+// overwritten) and keeps a rolling window of frame times.
+// On exit the events can be written as Chrome trace JSON (chrome://tracing or
+// ui.perfetto.dev) and the frame times as p50/p99/max summaries.
+class Profiler {
+public:
+    static Profiler& Get();
+
+    static uint64_t NowNs();
+    void Record(const char* name, uint64_t startNs, uint64_t endNs);
+    // Marks the end of a frame (call from the main loop only)
+    void EndFrame();
+
+    // Writes <prefix>_trace.json and <prefix>_summary.log
+    void WriteReports(const char* prefix);
+
+private:
+    Profiler();
+    bool WriteChromeTrace(const char* fileName, const std::vector<ProfileEvent>& events);
+    bool WriteSummary(const char* fileName, const std::vector<ProfileEvent>& events);
+    // Copies the events still in the ring, oldest first
+    void Snapshot(std::vector<ProfileEvent>& events);
+
+    // A slot is valid for event index i once its sequence is i + 1
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        ProfileEvent event;
+    };
+    static const uint64_t kRingSize = 1 << 16;
+    static const int kFrameWindow = 600;
+
+    Slot* mRing;
+    std::atomic<uint64_t> mWriteIndex;
+    // rolling frame times (ms)
+    float mFrameTimes[kFrameWindow];
+    int mFrameCount;
+    uint64_t mFrameStartNs;
+};
+
+// Times the enclosing scope
+class ProfileScope {
+public:
+    ProfileScope(const char* name) : mName(name), mStartNs(Profiler::NowNs()) {}
+    ~ProfileScope() { Profiler::Get().Record(mName, mStartNs, Profiler::NowNs()); }
+
+private:
+    const char* mName;
+    uint64_t mStartNs;
+};
+
+#if PROFILING_ENABLED
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_END_FRAME() Profiler::Get().EndFrame()
+#define PROFILE_WRITE_REPORTS(prefix) Profiler::Get().WriteReports(prefix)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_END_FRAME() ((void)0)
+#define PROFILE_WRITE_REPORTS(prefix) ((void)0)
+#endif
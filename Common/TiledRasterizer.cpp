@@ -0,0 +1,427 @@
+#include "TiledRasterizer.h"
+#include "JobSystem.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RASTER_X86 1
+#include <immintrin.h>
+#endif
+
+static double MsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// color over dst with color's alpha; the result's alpha is a + dstA * (1 - a).
+// Two channels per 32-bit word, each divided by 255 with rounding
+// (t + 128 + ((t + 128) >> 8)) >> 8, so it matches the SSE2 path bit for bit.
+static inline uint32_t BlendPixel(uint32_t dst, uint32_t color) {
+    uint32_t a = color >> 24;
+    uint32_t ia = 255 - a;
+    uint32_t rb = (color & 0x00FF00FF) * a + (dst & 0x00FF00FF) * ia + 0x00800080;
+    uint32_t ag = (((color | 0xFF000000) >> 8) & 0x00FF00FF) * a + ((dst >> 8) & 0x00FF00FF) * ia + 0x00800080;
+    rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+    ag = (ag + ((ag >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+    return rb | ag;
+}
+
+static void FillSpanScalar(uint32_t* dst, int count, uint32_t color) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = color;
+    }
+}
+
+static void BlendSpanScalar(uint32_t* dst, int count, uint32_t color) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = BlendPixel(dst[i], color);
+    }
+}
+
+#ifdef RASTER_X86
+
+__attribute__((target("sse2"))) static void FillSpanSse(uint32_t* dst, int count, uint32_t color) {
+    const __m128i value = _mm_set1_epi32(static_cast<int>(color));
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), value);
+    }
+    for (; i < count; i++) {
+        dst[i] = color;
+    }
+}
+
+// Widens 4 pixels to 16-bit channels: dst * (255 - a) + color * a + 128, then
+// the same rounded divide by 255 as BlendPixel
+__attribute__((target("sse2"))) static void BlendSpanSse(uint32_t* dst, int count, uint32_t color) {
+    const int a = color >> 24;
+    const __m128i zero = _mm_setzero_si128();
+    // the alpha lane uses 255, like BlendPixel
+    const __m128i src = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(color | 0xFF000000)), zero);
+    const __m128i srcTimesA = _mm_add_epi16(_mm_mullo_epi16(src, _mm_set1_epi16(a)), _mm_set1_epi16(0x80));
+    const __m128i inverse = _mm_set1_epi16(255 - a);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), inverse), srcTimesA);
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), inverse), srcTimesA);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    for (; i < count; i++) {
+        dst[i] = BlendPixel(dst[i], color);
+    }
+}
+
+static bool HasSseSpans() {
+    return __builtin_cpu_supports("sse2");
+}
+
+#else
+
+static void FillSpanSse(uint32_t* dst, int count, uint32_t color) {
+    FillSpanScalar(dst, count, color);
+}
+
+static void BlendSpanSse(uint32_t* dst, int count, uint32_t color) {
+    BlendSpanScalar(dst, count, color);
+}
+
+static bool HasSseSpans() {
+    return false;
+}
+
+#endif
+
+static void FillSpan(uint32_t* dst, int count, uint32_t color) {
+    static const bool sse = HasSseSpans();
+    if (sse) {
+        FillSpanSse(dst, count, color);
+    } else {
+        FillSpanScalar(dst, count, color);
+    }
+}
+
+static void BlendSpan(uint32_t* dst, int count, uint32_t color) {
+    static const bool sse = HasSseSpans();
+    if (sse) {
+        BlendSpanSse(dst, count, color);
+    } else {
+        BlendSpanScalar(dst, count, color);
+    }
+}
+
+TiledRasterizer::TiledRasterizer(int tileSize) {
+    mTileSize = tileSize;
+    mWidth = 0;
+    mHeight = 0;
+    mTilesX = 0;
+    mTilesY = 0;
+    mJobs = nullptr;
+    mStats = {};
+}
+
+void TiledRasterizer::Resize(int width, int height) {
+    mWidth = width;
+    mHeight = height;
+    mTilesX = (width + mTileSize - 1) / mTileSize;
+    mTilesY = (height + mTileSize - 1) / mTileSize;
+    mPixels.assign(static_cast<size_t>(width) * height, 0xFF000000);
+    mBins.resize(mTilesX * mTilesY);
+    mTileMs.assign(mTilesX * mTilesY, 0.0);
+    mCommands.clear();
+}
+
+void TiledRasterizer::Clear(uint32_t color) {
+    FillRect({0, 0, mWidth, mHeight}, color);
+}
+
+void TiledRasterizer::FillRect(const RasterRect& rect, uint32_t color) {
+    if ((color >> 24) == 0) {
+        return;
+    }
+    Command command;
+    command.type = (color >> 24) == 255 ? kFill : kFillBlend;
+    command.color = color;
+    Record(command, rect);
+}
+
+// Smallest k with k * step + step / 2 >= limit (step > 0), i.e. the first dst
+// offset whose 16.16 sample reaches limit
+static int64_t FirstSampleAtLeast(int64_t limit, int64_t step) {
+    int64_t numerator = limit - step / 2;
+    int64_t k = numerator / step;
+    return k * step < numerator ? k + 1 : k;
+}
+
+// Narrows the dst span [dst, dst + count) to the offsets whose sample (the
+// same one ShadeBlit takes) lands in [0, size) of the image
+static void ClipToImage(int srcStart, int64_t step, int size, int& dstStart, int& count) {
+    int64_t first = FirstSampleAtLeast(static_cast<int64_t>(-srcStart) << 16, step);
+    int64_t end = FirstSampleAtLeast(static_cast<int64_t>(size - srcStart) << 16, step);
+    first = first > 0 ? first : 0;
+    end = end < count ? end : count;
+    dstStart += static_cast<int>(first);
+    count = end > first ? static_cast<int>(end - first) : 0;
+}
+
+void TiledRasterizer::Blit(const RasterImage& image, const RasterRect& src, const RasterRect& dst, bool blend) {
+    if (!image.pixels || src.w <= 0 || src.h <= 0 || dst.w <= 0 || dst.h <= 0) {
+        return;
+    }
+    int64_t stepX = (static_cast<int64_t>(src.w) << 16) / dst.w;
+    int64_t stepY = (static_cast<int64_t>(src.h) << 16) / dst.h;
+    if (stepX == 0 || stepY == 0) {
+        return;
+    }
+    // where dst is drawn; command.dst stays the full rect the mapping uses
+    RasterRect visible = dst;
+    ClipToImage(src.x, stepX, image.width, visible.x, visible.w);
+    ClipToImage(src.y, stepY, image.height, visible.y, visible.h);
+    if (visible.w <= 0 || visible.h <= 0) {
+        return;
+    }
+    Command command;
+    command.type = blend ? kBlitBlend : kBlit;
+    command.color = 0;
+    command.image = image;
+    command.src = src;
+    command.dst = dst;
+    Record(command, visible);
+}
+
+void TiledRasterizer::Record(Command& command, const RasterRect& dst) {
+    int x0 = dst.x > 0 ? dst.x : 0;
+    int y0 = dst.y > 0 ? dst.y : 0;
+    int x1 = dst.x + dst.w < mWidth ? dst.x + dst.w : mWidth;
+    int y1 = dst.y + dst.h < mHeight ? dst.y + dst.h : mHeight;
+    if (x1 <= x0 || y1 <= y0) {
+        return;
+    }
+    command.clip = {x0, y0, x1 - x0, y1 - y0};
+    mCommands.push_back(command);
+}
+
+void TiledRasterizer::Execute() {
+    auto start = std::chrono::steady_clock::now();
+    int numTiles = mTilesX * mTilesY;
+    int numCommands = static_cast<int>(mCommands.size());
+    for (std::vector<int>& bin : mBins) {
+        bin.clear();
+    }
+    // every command goes to each tile its clipped rect overlaps, in order
+    int binEntries = 0;
+    for (int i = 0; i < numCommands; i++) {
+        const RasterRect& clip = mCommands[i].clip;
+        int tx0 = clip.x / mTileSize;
+        int ty0 = clip.y / mTileSize;
+        int tx1 = (clip.x + clip.w - 1) / mTileSize;
+        int ty1 = (clip.y + clip.h - 1) / mTileSize;
+        for (int ty = ty0; ty <= ty1; ty++) {
+            for (int tx = tx0; tx <= tx1; tx++) {
+                mBins[ty * mTilesX + tx].push_back(i);
+            }
+        }
+        binEntries += (tx1 - tx0 + 1) * (ty1 - ty0 + 1);
+    }
+    mStats.binMs = MsSince(start);
+
+    auto shadeStart = std::chrono::steady_clock::now();
+    if (mJobs) {
+        // one tile per job: tiles differ a lot in cost, stealing evens that out
+        mJobs->ParallelFor(numTiles, 1, [this](int begin, int end) {
+            for (int tile = begin; tile < end; tile++) {
+                ShadeTile(tile);
+            }
+        });
+    } else {
+        for (int tile = 0; tile < numTiles; tile++) {
+            ShadeTile(tile);
+        }
+    }
+    mStats.shadeMs = MsSince(shadeStart);
+
+    mStats.commands = numCommands;
+    mStats.binEntries = binEntries;
+    mStats.tilesShaded = 0;
+    mStats.maxTileMs = 0.0;
+    for (int tile = 0; tile < numTiles; tile++) {
+        mStats.tilesShaded += !mBins[tile].empty();
+        if (mTileMs[tile] > mStats.maxTileMs) {
+            mStats.maxTileMs = mTileMs[tile];
+        }
+    }
+    // the bins are cleared as they're refilled by the next Execute
+    mCommands.clear();
+}
+
+void TiledRasterizer::ShadeTile(int tile) {
+    const std::vector<int>& bin = mBins[tile];
+    if (bin.empty()) {
+        mTileMs[tile] = 0.0;
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    int tileX0 = (tile % mTilesX) * mTileSize;
+    int tileY0 = (tile / mTilesX) * mTileSize;
+    int tileX1 = tileX0 + mTileSize < mWidth ? tileX0 + mTileSize : mWidth;
+    int tileY1 = tileY0 + mTileSize < mHeight ? tileY0 + mTileSize : mHeight;
+    for (int index : bin) {
+        const Command& command = mCommands[index];
+        const RasterRect& clip = command.clip;
+        int x0 = clip.x > tileX0 ? clip.x : tileX0;
+        int y0 = clip.y > tileY0 ? clip.y : tileY0;
+        int x1 = clip.x + clip.w < tileX1 ? clip.x + clip.w : tileX1;
+        int y1 = clip.y + clip.h < tileY1 ? clip.y + clip.h : tileY1;
+        uint32_t* row = mPixels.data() + static_cast<size_t>(y0) * mWidth + x0;
+        switch (command.type) {
+        case kFill:
+            for (int y = y0; y < y1; y++, row += mWidth) {
+                FillSpan(row, x1 - x0, command.color);
+            }
+            break;
+        case kFillBlend:
+            for (int y = y0; y < y1; y++, row += mWidth) {
+                BlendSpan(row, x1 - x0, command.color);
+            }
+            break;
+        case kBlit:
+        case kBlitBlend:
+            ShadeBlit(command, x0, y0, x1, y1);
+            break;
+        }
+    }
+    mTileMs[tile] = MsSince(start);
+}
+
+void TiledRasterizer::ShadeBlit(const Command& command, int x0, int y0, int x1, int y1) {
+    const RasterRect& src = command.src;
+    const RasterRect& dst = command.dst;
+    const RasterImage& image = command.image;
+    bool blend = command.type == kBlitBlend;
+    // 16.16 fixed point through the source, sampling at pixel centers. The
+    // sample only depends on the pixel's offset in dst, never on where the
+    // tile starts, so output doesn't change with the tile size.
+    int64_t stepX = (static_cast<int64_t>(src.w) << 16) / dst.w;
+    int64_t stepY = (static_cast<int64_t>(src.h) << 16) / dst.h;
+    int64_t startX = (x0 - dst.x) * stepX + stepX / 2;
+    for (int y = y0; y < y1; y++) {
+        int sy = src.y + static_cast<int>(((y - dst.y) * stepY + stepY / 2) >> 16);
+        const uint32_t* in = image.pixels + static_cast<size_t>(sy) * image.pitch + src.x;
+        uint32_t* out = mPixels.data() + static_cast<size_t>(y) * mWidth;
+        if (!blend && src.w == dst.w) {
+            // unscaled copy
+            memcpy(out + x0, in + (x0 - dst.x), (x1 - x0) * sizeof(uint32_t));
+            continue;
+        }
+        int64_t u = startX;
+        for (int x = x0; x < x1; x++, u += stepX) {
+            uint32_t pixel = in[u >> 16];
+            out[x] = blend ? BlendPixel(out[x], pixel) : pixel;
+        }
+    }
+}
+
+bool TiledRasterizer::SaveRaw(const char* fileName) const {
+    FILE* file = fopen(fileName, "wb");
+    if (!file) {
+        return false;
+    }
+    size_t count = mPixels.size();
+    bool ok = fwrite(mPixels.data(), sizeof(uint32_t), count, file) == count;
+    return fclose(file) == 0 && ok;
+}
+
+static uint32_t Crc32(uint32_t crc, const unsigned char* data, size_t size) {
+    static uint32_t table[256];
+    static bool tableReady = false;
+    if (!tableReady) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+        tableReady = true;
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void PutBigEndian(std::vector<unsigned char>& out, uint32_t value) {
+    out.push_back(value >> 24);
+    out.push_back(value >> 16);
+    out.push_back(value >> 8);
+    out.push_back(value);
+}
+
+// Length, type, data, CRC of type + data
+static void PutChunk(std::vector<unsigned char>& out, const char* type, const std::vector<unsigned char>& data) {
+    PutBigEndian(out, static_cast<uint32_t>(data.size()));
+    size_t typeStart = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    PutBigEndian(out, Crc32(0, out.data() + typeStart, out.size() - typeStart));
+}
+
+bool TiledRasterizer::SavePng(const char* fileName) const {
+    // scanlines: filter type 0, then RGBA
+    std::vector<unsigned char> raw;
+    raw.reserve(static_cast<size_t>(mWidth * 4 + 1) * mHeight);
+    for (int y = 0; y < mHeight; y++) {
+        raw.push_back(0);
+        const uint32_t* row = mPixels.data() + static_cast<size_t>(y) * mWidth;
+        for (int x = 0; x < mWidth; x++) {
+            raw.push_back(row[x] >> 16);
+            raw.push_back(row[x] >> 8);
+            raw.push_back(row[x]);
+            raw.push_back(row[x] >> 24);
+        }
+    }
+
+    // zlib stream of stored (uncompressed) deflate blocks, then the Adler-32
+    std::vector<unsigned char> zlib = {0x78, 0x01};
+    size_t offset = 0;
+    do {
+        size_t length = raw.size() - offset < 65535 ? raw.size() - offset : 65535;
+        zlib.push_back(offset + length == raw.size() ? 1 : 0);
+        zlib.push_back(length & 0xFF);
+        zlib.push_back(length >> 8);
+        zlib.push_back(~length & 0xFF);
+        zlib.push_back((~length >> 8) & 0xFF);
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + length);
+        offset += length;
+    } while (offset < raw.size());
+    uint32_t a = 1;
+    uint32_t b = 0;
+    for (unsigned char byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    PutBigEndian(zlib, (b << 16) | a);
+
+    std::vector<unsigned char> header;
+    PutBigEndian(header, mWidth);
+    PutBigEndian(header, mHeight);
+    // 8 bits per channel, RGBA, deflate, adaptive filtering, no interlace
+    const unsigned char format[5] = {8, 6, 0, 0, 0};
+    header.insert(header.end(), format, format + 5);
+
+    const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    std::vector<unsigned char> png(signature, signature + 8);
+    PutChunk(png, "IHDR", header);
+    PutChunk(png, "IDAT", zlib);
+    PutChunk(png, "IEND", {});
+
+    FILE* file = fopen(fileName, "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = fwrite(png.data(), 1, png.size(), file) == png.size();
+    return fclose(file) == 0 && ok;
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+class JobSystem;
+
+// Rectangle in pixels (of the framebuffer or of an image)
+struct RasterRect {
+    int x;
+    int y;
+    int w;
+    int h;
+};
+
+// Pixels a blit reads from: 32-bit ARGB (0xAARRGGBB), pitch in pixels
+struct RasterImage {
+    const uint32_t* pixels;
+    int width;
+    int height;
+    int pitch;
+};
+
+// Counts and timing of the last Execute
+struct RasterStats {
+    int commands;    // draws recorded
+    int binEntries;  // (draw, tile) pairs after binning
+    int tilesShaded; // tiles that had at least one draw
+    double binMs;
+    double shadeMs;   // wall time of the (parallel) shading
+    double maxTileMs; // slowest single tile
+};
+
+// Renders into an in-memory ARGB framebuffer without a GPU or SDL_Renderer.
+// Draws are only recorded; Execute bins each one into every screen tile it
+// overlaps (keeping submission order) and then shades the tiles in parallel
+// on a JobSystem. A tile is only ever touched by one thread, so shading needs
+// no locks, and painter's order holds within every tile. Spans are filled 4
+// pixels at a time with SSE2 where the CPU has it.
+// The command list and the per-tile bins keep their capacity across Execute
+// calls; recording allocates only when a frame outgrows every earlier one.
+class TiledRasterizer {
+public:
+    TiledRasterizer(int tileSize = 64);
+    // (Re)allocates a width x height framebuffer, cleared to opaque black
+    void Resize(int width, int height);
+    // Tiles are shaded on jobs (nullptr shades them on the calling thread)
+    void SetJobSystem(JobSystem* jobs) { mJobs = jobs; }
+
+    // Colors are ARGB; alpha below 255 blends over what's already there
+    void Clear(uint32_t color);
+    void FillRect(const RasterRect& rect, uint32_t color);
+    // Nearest-neighbor (scaled) copy of src, in image pixels, to dst; blend
+    // uses the image's alpha. Parts of src outside the image aren't drawn
+    // (the dst pixels that would sample them are left as they are). The
+    // pixels must stay valid until Execute.
+    void Blit(const RasterImage& image, const RasterRect& src, const RasterRect& dst, bool blend);
+    // Draws everything recorded since the last Execute
+    void Execute();
+
+    int GetWidth() const { return mWidth; }
+    int GetHeight() const { return mHeight; }
+    // Rows are tightly packed (pitch is the width)
+    const uint32_t* GetPixels() const { return mPixels.data(); }
+    int GetTileSize() const { return mTileSize; }
+    int GetTilesX() const { return mTilesX; }
+    int GetTilesY() const { return mTilesY; }
+    // Shading time of every tile in the last Execute (ms), row by row
+    const std::vector<double>& GetTileMs() const { return mTileMs; }
+    const RasterStats& GetStats() const { return mStats; }
+
+    // Framebuffer dumps for golden-image comparisons. Raw is the pixels as
+    // stored (width * height ARGB words, native byte order, no header); PNG
+    // is 8-bit RGBA (uncompressed, so no zlib is needed)
+    bool SaveRaw(const char* fileName) const;
+    bool SavePng(const char* fileName) const;
+
+private:
+    enum CommandType { kFill, kFillBlend, kBlit, kBlitBlend };
+    struct Command {
+        CommandType type;
+        // where it draws, clipped to the framebuffer
+        RasterRect clip;
+        uint32_t color;
+        // blits map dst (unclipped) onto src
+        RasterImage image;
+        RasterRect src;
+        RasterRect dst;
+    };
+    // Clips dst and records the command (nothing if it's off screen)
+    void Record(Command& command, const RasterRect& dst);
+    void ShadeTile(int tile);
+    void ShadeBlit(const Command& command, int x0, int y0, int x1, int y1);
+
+    int mTileSize;
+    int mWidth;
+    int mHeight;
+    int mTilesX;
+    int mTilesY;
+    std::vector<uint32_t> mPixels;
+    std::vector<Command> mCommands;
+    // command indices per tile, in submission order
+    std::vector<std::vector<int>> mBins;
+    std::vector<double> mTileMs;
+    JobSystem* mJobs;
+    RasterStats mStats;
+};
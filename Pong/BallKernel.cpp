@@ -0,0 +1,229 @@
+#include "BallKernel.h"
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BALL_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+int UpdateBallsScalar(BallStore& balls, int begin, int end, const BallKernelParams& params) {
+    float* xs = balls.x.data();
+    float* ys = balls.y.data();
+    float* vxs = balls.vx.data();
+    float* vys = balls.vy.data();
+    unsigned char* flags = balls.flags.data();
+    int outCount = 0;
+
+    for (int i = begin; i < end; i++) {
+        float vx = vxs[i];
+        float vy = vys[i];
+        // integrate
+        float x = xs[i] + vx * params.deltaTime;
+        float y = ys[i] + vy * params.deltaTime;
+
+        // top/bottom wall (only when moving into it, so the ball can't get stuck)
+        bool flipY = (y <= params.wallTop && vy < 0.0f) || (y >= params.wallBottom && vy > 0.0f);
+        vy = flipY ? -vy : vy;
+
+        // paddles (paddle 2 sees the velocity after paddle 1)
+        bool hit1 = std::fabs(y - params.paddle1Y) <= params.paddleHalfH &&
+                    x <= params.paddle1MaxX && x >= params.paddle1MinX && vx < 0.0f;
+        vx = hit1 ? -vx : vx;
+        bool hit2 = std::fabs(y - params.paddle2Y) <= params.paddleHalfH &&
+                    x >= params.paddle2MinX && x <= params.paddle2MaxX && vx > 0.0f;
+        vx = hit2 ? -vx : vx;
+
+        bool out = (x - params.ballHalf) < 0.0f || (x + params.ballHalf) > params.fieldWidth;
+
+        xs[i] = x;
+        ys[i] = y;
+        vxs[i] = vx;
+        vys[i] = vy;
+        flags[i] = (out ? kBallOut : 0) | (hit1 || hit2 ? kBallHitPaddle : 0);
+        outCount += out;
+    }
+    return outCount;
+}
+
+#ifdef BALL_KERNEL_X86
+
+// Every test below becomes an all-ones/all-zeros lane mask; reflections are an
+// xor of the sign bit under the mask, so there are no branches per ball.
+
+__attribute__((target("sse2"))) int UpdateBallsSse(BallStore& balls, int begin, int end, const BallKernelParams& params) {
+    float* xs = balls.x.data();
+    float* ys = balls.y.data();
+    float* vxs = balls.vx.data();
+    float* vys = balls.vy.data();
+    unsigned char* flags = balls.flags.data();
+
+    const __m128 dt = _mm_set1_ps(params.deltaTime);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 p1Y = _mm_set1_ps(params.paddle1Y);
+    const __m128 p2Y = _mm_set1_ps(params.paddle2Y);
+    const __m128 halfH = _mm_set1_ps(params.paddleHalfH);
+    const __m128 top = _mm_set1_ps(params.wallTop);
+    const __m128 bottom = _mm_set1_ps(params.wallBottom);
+    const __m128 p1Min = _mm_set1_ps(params.paddle1MinX);
+    const __m128 p1Max = _mm_set1_ps(params.paddle1MaxX);
+    const __m128 p2Min = _mm_set1_ps(params.paddle2MinX);
+    const __m128 p2Max = _mm_set1_ps(params.paddle2MaxX);
+    const __m128 ballHalf = _mm_set1_ps(params.ballHalf);
+    const __m128 width = _mm_set1_ps(params.fieldWidth);
+
+    int outCount = 0;
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 vx = _mm_loadu_ps(vxs + i);
+        __m128 vy = _mm_loadu_ps(vys + i);
+        __m128 x = _mm_add_ps(_mm_loadu_ps(xs + i), _mm_mul_ps(vx, dt));
+        __m128 y = _mm_add_ps(_mm_loadu_ps(ys + i), _mm_mul_ps(vy, dt));
+
+        __m128 flipY = _mm_or_ps(_mm_and_ps(_mm_cmple_ps(y, top), _mm_cmplt_ps(vy, zero)),
+                                 _mm_and_ps(_mm_cmpge_ps(y, bottom), _mm_cmpgt_ps(vy, zero)));
+        vy = _mm_xor_ps(vy, _mm_and_ps(flipY, sign));
+
+        __m128 hit1 = _mm_cmple_ps(_mm_andnot_ps(sign, _mm_sub_ps(y, p1Y)), halfH);
+        hit1 = _mm_and_ps(hit1, _mm_and_ps(_mm_cmple_ps(x, p1Max), _mm_cmpge_ps(x, p1Min)));
+        hit1 = _mm_and_ps(hit1, _mm_cmplt_ps(vx, zero));
+        vx = _mm_xor_ps(vx, _mm_and_ps(hit1, sign));
+        __m128 hit2 = _mm_cmple_ps(_mm_andnot_ps(sign, _mm_sub_ps(y, p2Y)), halfH);
+        hit2 = _mm_and_ps(hit2, _mm_and_ps(_mm_cmpge_ps(x, p2Min), _mm_cmple_ps(x, p2Max)));
+        hit2 = _mm_and_ps(hit2, _mm_cmpgt_ps(vx, zero));
+        vx = _mm_xor_ps(vx, _mm_and_ps(hit2, sign));
+
+        __m128 out = _mm_or_ps(_mm_cmplt_ps(_mm_sub_ps(x, ballHalf), zero),
+                               _mm_cmpgt_ps(_mm_add_ps(x, ballHalf), width));
+
+        _mm_storeu_ps(xs + i, x);
+        _mm_storeu_ps(ys + i, y);
+        _mm_storeu_ps(vxs + i, vx);
+        _mm_storeu_ps(vys + i, vy);
+        int outMask = _mm_movemask_ps(out);
+        int hitMask = _mm_movemask_ps(_mm_or_ps(hit1, hit2));
+        for (int lane = 0; lane < 4; lane++) {
+            flags[i + lane] = ((outMask >> lane) & 1) * kBallOut | ((hitMask >> lane) & 1) * kBallHitPaddle;
+        }
+        outCount += __builtin_popcount(outMask);
+    }
+    return outCount + UpdateBallsScalar(balls, i, end, params);
+}
+
+__attribute__((target("avx2"))) int UpdateBallsAvx2(BallStore& balls, int begin, int end, const BallKernelParams& params) {
+    float* xs = balls.x.data();
+    float* ys = balls.y.data();
+    float* vxs = balls.vx.data();
+    float* vys = balls.vy.data();
+    unsigned char* flags = balls.flags.data();
+
+    const __m256 dt = _mm256_set1_ps(params.deltaTime);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 p1Y = _mm256_set1_ps(params.paddle1Y);
+    const __m256 p2Y = _mm256_set1_ps(params.paddle2Y);
+    const __m256 halfH = _mm256_set1_ps(params.paddleHalfH);
+    const __m256 top = _mm256_set1_ps(params.wallTop);
+    const __m256 bottom = _mm256_set1_ps(params.wallBottom);
+    const __m256 p1Min = _mm256_set1_ps(params.paddle1MinX);
+    const __m256 p1Max = _mm256_set1_ps(params.paddle1MaxX);
+    const __m256 p2Min = _mm256_set1_ps(params.paddle2MinX);
+    const __m256 p2Max = _mm256_set1_ps(params.paddle2MaxX);
+    const __m256 ballHalf = _mm256_set1_ps(params.ballHalf);
+    const __m256 width = _mm256_set1_ps(params.fieldWidth);
+    // movemask bit -> one flag byte per lane
+    const __m128i laneBits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i one = _mm_set1_epi8(1);
+
+    int outCount = 0;
+    int i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 vx = _mm256_loadu_ps(vxs + i);
+        __m256 vy = _mm256_loadu_ps(vys + i);
+        __m256 x = _mm256_add_ps(_mm256_loadu_ps(xs + i), _mm256_mul_ps(vx, dt));
+        __m256 y = _mm256_add_ps(_mm256_loadu_ps(ys + i), _mm256_mul_ps(vy, dt));
+
+        __m256 flipY = _mm256_or_ps(
+            _mm256_and_ps(_mm256_cmp_ps(y, top, _CMP_LE_OQ), _mm256_cmp_ps(vy, zero, _CMP_LT_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(y, bottom, _CMP_GE_OQ), _mm256_cmp_ps(vy, zero, _CMP_GT_OQ)));
+        vy = _mm256_xor_ps(vy, _mm256_and_ps(flipY, sign));
+
+        __m256 hit1 = _mm256_cmp_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(y, p1Y)), halfH, _CMP_LE_OQ);
+        hit1 = _mm256_and_ps(hit1, _mm256_and_ps(_mm256_cmp_ps(x, p1Max, _CMP_LE_OQ), _mm256_cmp_ps(x, p1Min, _CMP_GE_OQ)));
+        hit1 = _mm256_and_ps(hit1, _mm256_cmp_ps(vx, zero, _CMP_LT_OQ));
+        vx = _mm256_xor_ps(vx, _mm256_and_ps(hit1, sign));
+        __m256 hit2 = _mm256_cmp_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(y, p2Y)), halfH, _CMP_LE_OQ);
+        hit2 = _mm256_and_ps(hit2, _mm256_and_ps(_mm256_cmp_ps(x, p2Min, _CMP_GE_OQ), _mm256_cmp_ps(x, p2Max, _CMP_LE_OQ)));
+        hit2 = _mm256_and_ps(hit2, _mm256_cmp_ps(vx, zero, _CMP_GT_OQ));
+        vx = _mm256_xor_ps(vx, _mm256_and_ps(hit2, sign));
+
+        __m256 out = _mm256_or_ps(_mm256_cmp_ps(_mm256_sub_ps(x, ballHalf), zero, _CMP_LT_OQ),
+                                  _mm256_cmp_ps(_mm256_add_ps(x, ballHalf), width, _CMP_GT_OQ));
+
+        _mm256_storeu_ps(xs + i, x);
+        _mm256_storeu_ps(ys + i, y);
+        _mm256_storeu_ps(vxs + i, vx);
+        _mm256_storeu_ps(vys + i, vy);
+        int outMask = _mm256_movemask_ps(out);
+        int hitMask = _mm256_movemask_ps(_mm256_or_ps(hit1, hit2));
+        // spread the 8 mask bits into 8 bytes of 0/1, then scale to the flag bits
+        __m128i outBytes = _mm_min_epu8(_mm_and_si128(_mm_set1_epi8(static_cast<char>(outMask)), laneBits), one);
+        __m128i hitBytes = _mm_min_epu8(_mm_and_si128(_mm_set1_epi8(static_cast<char>(hitMask)), laneBits), one);
+        __m128i bytes = _mm_or_si128(_mm_mullo_epi16(outBytes, _mm_set1_epi16(kBallOut)),
+                                     _mm_mullo_epi16(hitBytes, _mm_set1_epi16(kBallHitPaddle)));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(flags + i), bytes);
+        outCount += __builtin_popcount(outMask);
+    }
+    return outCount + UpdateBallsScalar(balls, i, end, params);
+}
+
+bool HasSseKernel() {
+    return __builtin_cpu_supports("sse2");
+}
+
+bool HasAvx2Kernel() {
+    return __builtin_cpu_supports("avx2");
+}
+
+#else
+
+int UpdateBallsSse(BallStore& balls, int begin, int end, const BallKernelParams& params) {
+    return UpdateBallsScalar(balls, begin, end, params);
+}
+
+int UpdateBallsAvx2(BallStore& balls, int begin, int end, const BallKernelParams& params) {
+    return UpdateBallsScalar(balls, begin, end, params);
+}
+
+bool HasSseKernel() {
+    return false;
+}
+
+bool HasAvx2Kernel() {
+    return false;
+}
+
+#endif
+
+int UpdateBalls(BallStore& balls, int begin, int end, const BallKernelParams& params) {
+    // resolved once, the CPU doesn't change under us
+    static const bool avx2 = HasAvx2Kernel();
+    static const bool sse = HasSseKernel();
+    if (avx2) {
+        return UpdateBallsAvx2(balls, begin, end, params);
+    }
+    if (sse) {
+        return UpdateBallsSse(balls, begin, end, params);
+    }
+    return UpdateBallsScalar(balls, begin, end, params);
+}
+
+const char* BallKernelName() {
+    if (HasAvx2Kernel()) {
+        return "avx2";
+    }
+    if (HasSseKernel()) {
+        return "sse2";
+    }
+    return "scalar";
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "BallStore.h"
+
+// Playfield constants the kernel collides against
+struct BallKernelParams {
+    float deltaTime;
+    float paddle1Y;
+    float paddle2Y;
+    float paddleHalfH;
+    float wallTop;    // bounce when y <= wallTop and moving up
+    float wallBottom; // bounce when y >= wallBottom and moving down
+    // x range where a ball touches paddle 1/2
+    float paddle1MinX, paddle1MaxX;
+    float paddle2MinX, paddle2MaxX;
+    // ball is out when x - ballHalf < 0 or x + ballHalf > fieldWidth
+    float ballHalf;
+    float fieldWidth;
+};
+
+// One fused pass over balls [begin, end): integrate, bounce off walls and
+// paddles, and set kBallOut/kBallHitPaddle in flags. Returns the number of
+// balls that are out.
+// All paths produce bit-identical results as long as the compiler does not
+// contract the integrate step into an FMA (build with -ffp-contract=off
+// when FMA is enabled).
+int UpdateBalls(BallStore& balls, int begin, int end, const BallKernelParams& params);
+
+// Individual paths (for benchmarking/validation)
+int UpdateBallsScalar(BallStore& balls, int begin, int end, const BallKernelParams& params);
+int UpdateBallsSse(BallStore& balls, int begin, int end, const BallKernelParams& params);
+int UpdateBallsAvx2(BallStore& balls, int begin, int end, const BallKernelParams& params);
+// Which paths this CPU/build can run
+bool HasSseKernel();
+bool HasAvx2Kernel();
+// Name of the path UpdateBalls dispatches to
+const char* BallKernelName();
@@ -0,0 +1,151 @@
+#include "BallKernel.h"
+#include "Game.h"
+#include "Random.h"
+#include <chrono>
+#include <cstring>
+
+const int benchBalls = 1000000;
+const int benchTicks = 200;
+const float fieldWidth = 1024.0f;
+const float fieldHeight = 700.0f;
+
+// The original five-pass update over an array of Ball structs, kept as the baseline
+int UpdateBallsLegacy(std::vector<Ball>& balls, const BallKernelParams& params) {
+    int numBalls = static_cast<int>(balls.size());
+    for (int i = 0; i < numBalls; i++) {
+        balls[i].Pos.x += balls[i].Vec.x * params.deltaTime;
+        balls[i].Pos.y += balls[i].Vec.y * params.deltaTime;
+    }
+    for (int i = 0; i < numBalls; i++) {
+        if (balls[i].Pos.y <= params.wallTop && balls[i].Vec.y < 0.0f) {
+            balls[i].Vec.y *= -1;
+        } else if (balls[i].Pos.y >= params.wallBottom && balls[i].Vec.y > 0.0f) {
+            balls[i].Vec.y *= -1;
+        }
+    }
+    for (int i = 0; i < numBalls; i++) {
+        float diff1 = std::abs(balls[i].Pos.y - params.paddle1Y);
+        if (diff1 <= params.paddleHalfH &&
+            balls[i].Pos.x <= params.paddle1MaxX && balls[i].Pos.x >= params.paddle1MinX &&
+            balls[i].Vec.x < 0.0f) {
+            balls[i].Vec.x *= -1.0f;
+        }
+    }
+    for (int i = 0; i < numBalls; i++) {
+        float diff2 = std::abs(balls[i].Pos.y - params.paddle2Y);
+        if (diff2 <= params.paddleHalfH &&
+            balls[i].Pos.x >= params.paddle2MinX && balls[i].Pos.x <= params.paddle2MaxX &&
+            balls[i].Vec.x > 0.0f) {
+            balls[i].Vec.x *= -1.0f;
+        }
+    }
+    int outCount = 0;
+    for (int i = 0; i < numBalls; i++) {
+        if ((balls[i].Pos.x - params.ballHalf) < 0 || (balls[i].Pos.x + params.ballHalf) > params.fieldWidth) {
+            outCount++;
+        }
+    }
+    return outCount;
+}
+
+BallKernelParams MakeParams() {
+    BallKernelParams params;
+    params.deltaTime = 1.0f / 60.0f;
+    params.paddle1Y = fieldHeight / 2.0f;
+    params.paddle2Y = fieldHeight / 2.0f;
+    params.paddleHalfH = 50.0f;
+    params.wallTop = 15.0f;
+    params.wallBottom = fieldHeight - 15.0f;
+    params.paddle1MinX = 20.0f;
+    params.paddle1MaxX = 25.0f;
+    params.paddle2MinX = fieldWidth - 25.0f;
+    params.paddle2MaxX = fieldWidth - 20.0f;
+    params.ballHalf = 7.0f;
+    params.fieldWidth = fieldWidth;
+    return params;
+}
+
+// Balls spread over the whole field so every wall/paddle branch gets exercised
+void MakeBalls(std::vector<Ball>& aos, BallStore& soa) {
+    Random random(1234);
+    soa.Reserve(benchBalls);
+    for (int i = 0; i < benchBalls; i++) {
+        float x = static_cast<float>(random.NextInt(1000) + 12);
+        float y = static_cast<float>(random.NextInt(680) + 10);
+        float vx = static_cast<float>(random.NextInt(40) + 70);
+        vx *= random.NextInt(2) == 0 ? -1.0f : 1.0f;
+        float vy = static_cast<float>(random.NextInt(40) + 70);
+        vy *= random.NextInt(2) == 0 ? -1.0f : 1.0f;
+        aos.push_back({{x, y}, {vx, vy}});
+        soa.Spawn(x, y, vx, vy);
+    }
+}
+
+bool SameBits(const std::vector<float>& a, const std::vector<float>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+bool SameBits(const std::vector<Ball>& aos, const BallStore& soa) {
+    for (int i = 0; i < soa.Count(); i++) {
+        if (std::memcmp(&aos[i].Pos.x, &soa.x[i], sizeof(float)) != 0 ||
+            std::memcmp(&aos[i].Pos.y, &soa.y[i], sizeof(float)) != 0 ||
+            std::memcmp(&aos[i].Vec.x, &soa.vx[i], sizeof(float)) != 0 ||
+            std::memcmp(&aos[i].Vec.y, &soa.vy[i], sizeof(float)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Fn>
+double TimeTicks(Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < benchTicks; tick++) {
+        fn();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / (static_cast<double>(benchTicks) * benchBalls);
+}
+
+int main(int argc, char **argv) {
+    const BallKernelParams params = MakeParams();
+    std::vector<Ball> legacy;
+    BallStore reference;
+    MakeBalls(legacy, reference);
+    BallStore sse = reference;
+    BallStore avx2 = reference;
+    BallStore dispatched = reference;
+
+    int legacyOut = 0, scalarOut = 0, sseOut = 0, avx2Out = 0, dispatchedOut = 0;
+    double legacyNs = TimeTicks([&] { legacyOut = UpdateBallsLegacy(legacy, params); });
+    double scalarNs = TimeTicks([&] { scalarOut = UpdateBallsScalar(reference, 0, benchBalls, params); });
+    double sseNs = TimeTicks([&] { sseOut = UpdateBallsSse(sse, 0, benchBalls, params); });
+    double avx2Ns = 0.0;
+    if (HasAvx2Kernel()) {
+        avx2Ns = TimeTicks([&] { avx2Out = UpdateBallsAvx2(avx2, 0, benchBalls, params); });
+    }
+    double dispatchedNs = TimeTicks([&] { dispatchedOut = UpdateBalls(dispatched, 0, benchBalls, params); });
+
+    printf("%d balls, %d ticks (UpdateBalls uses %s)\n", benchBalls, benchTicks, BallKernelName());
+    printf("%-16s %14s %10s %8s\n", "path", "ns/ball/tick", "speedup", "match");
+    printf("%-16s %14.3f %10.2f %8s\n", "legacy aos", legacyNs, 1.0, "-");
+    printf("%-16s %14.3f %10.2f %8s\n", "soa scalar", scalarNs, legacyNs / scalarNs,
+           SameBits(legacy, reference) && legacyOut == scalarOut ? "yes" : "NO");
+    printf("%-16s %14.3f %10.2f %8s\n", "soa sse2", sseNs, legacyNs / sseNs,
+           SameBits(reference.x, sse.x) && SameBits(reference.y, sse.y) &&
+                   SameBits(reference.vx, sse.vx) && SameBits(reference.vy, sse.vy) &&
+                   reference.flags == sse.flags && scalarOut == sseOut
+               ? "yes"
+               : "NO");
+    if (HasAvx2Kernel()) {
+        printf("%-16s %14.3f %10.2f %8s\n", "soa avx2", avx2Ns, legacyNs / avx2Ns,
+               SameBits(reference.x, avx2.x) && SameBits(reference.y, avx2.y) &&
+                       SameBits(reference.vx, avx2.vx) && SameBits(reference.vy, avx2.vy) &&
+                       reference.flags == avx2.flags && scalarOut == avx2Out
+                   ? "yes"
+                   : "NO");
+    }
+    printf("%-16s %14.3f %10.2f\n", "UpdateBalls", dispatchedNs, legacyNs / dispatchedNs);
+    (void)dispatchedOut;
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include "BallStore.h"
+
+BallStore::BallStore() {
+    mCount = 0;
+    mPeakCount = 0;
+    mSpawnFailures = 0;
+    mAllocations = 0;
+}
+
+void BallStore::Reserve(int capacity) {
+    x.assign(capacity, 0.0f);
+    y.assign(capacity, 0.0f);
+    vx.assign(capacity, 0.0f);
+    vy.assign(capacity, 0.0f);
+    flags.assign(capacity, 0);
+    mIdAt.assign(capacity, kInvalidBall);
+    mIndexOfId.assign(capacity, -1);
+
+    // hand out low ids first
+    mFreeIds.resize(capacity);
+    for (int i = 0; i < capacity; i++) {
+        mFreeIds[i] = capacity - 1 - i;
+    }
+    mCount = 0;
+    mAllocations++;
+}
+
+BallId BallStore::Spawn(float posX, float posY, float vecX, float vecY) {
+    if (mFreeIds.empty()) {
+        mSpawnFailures++;
+        return kInvalidBall;
+    }
+    BallId id = mFreeIds.back();
+    mFreeIds.pop_back();
+
+    int index = mCount++;
+    x[index] = posX;
+    y[index] = posY;
+    vx[index] = vecX;
+    vy[index] = vecY;
+    flags[index] = 0;
+    mIdAt[index] = id;
+    mIndexOfId[id] = index;
+
+    if (mCount > mPeakCount) {
+        mPeakCount = mCount;
+    }
+    return id;
+}
+
+void BallStore::Retire(BallId id) {
+    int index = mIndexOfId[id];
+    if (index >= 0) {
+        RetireAt(index);
+    }
+}
+
+void BallStore::RetireAt(int index) {
+    BallId id = mIdAt[index];
+    int last = --mCount;
+    // move the last ball into the hole
+    if (index != last) {
+        x[index] = x[last];
+        y[index] = y[last];
+        vx[index] = vx[last];
+        vy[index] = vy[last];
+        flags[index] = flags[last];
+        mIdAt[index] = mIdAt[last];
+        mIndexOfId[mIdAt[index]] = index;
+    }
+    mIdAt[last] = kInvalidBall;
+    mIndexOfId[id] = -1;
+    // capacity was reserved up front, so this never reallocates
+    mFreeIds.push_back(id);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+
+// flags written by the ball kernel
+const unsigned char kBallOut = 1;       // ball left the screen on the x axis
+const unsigned char kBallHitPaddle = 2; // ball bounced off a paddle this tick
+
+// Stable name for a ball (its dense index changes when other balls are retired)
+typedef int BallId;
+const BallId kInvalidBall = -1;
+
+// Fixed-capacity ball pool stored as structure-of-arrays so the update kernel
+// can stream each component with full-width vector loads.
+// Live balls are packed into [0, Count()); retiring a ball moves the last one
+// into its place (swap-and-pop) and puts its id on a free list. All memory is
+// allocated by Reserve, so spawning/retiring never touches the heap.
+class BallStore {
+public:
+    BallStore();
+    // Allocate room for capacity balls (drops any live balls)
+    void Reserve(int capacity);
+    // Returns kInvalidBall if the pool is full
+    BallId Spawn(float posX, float posY, float vecX, float vecY);
+    void Retire(BallId id);
+    // Retire the ball currently stored at dense index
+    void RetireAt(int index);
+    // Dense index of a live ball (-1 if retired)
+    int IndexOf(BallId id) const { return mIndexOfId[id]; }
+    BallId IdAt(int index) const { return mIdAt[index]; }
+
+    int Count() const { return mCount; }
+    int Capacity() const { return static_cast<int>(mIdAt.size()); }
+    // Counters
+    int GetPeakCount() const { return mPeakCount; }         // most balls alive at once
+    int GetSpawnFailures() const { return mSpawnFailures; } // spawns rejected because the pool was full
+    int GetAllocations() const { return mAllocations; }     // times the pool allocated memory
+
+    // Ball data, valid for [0, Count())
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> vx;
+    std::vector<float> vy;
+    std::vector<unsigned char> flags;
+
+private:
+    int mCount;
+    // dense index -> id and id -> dense index
+    std::vector<BallId> mIdAt;
+    std::vector<int> mIndexOfId;
+    // ids not in use (used as a stack)
+    std::vector<BallId> mFreeIds;
+    int mPeakCount;
+    int mSpawnFailures;
+    int mAllocations;
+};
@@ -0,0 +1,58 @@
+#include "Random.h"
+#include "SpatialGrid.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+const float fieldWidth = 1024.0f;
+const float fieldHeight = 700.0f;
+const float ballRadius = 7.5f;
+const float cellSize = 16.0f;
+
+void MakeBalls(BallStore& balls, int count) {
+    Random random(99);
+    balls.Reserve(count);
+    for (int i = 0; i < count; i++) {
+        float x = static_cast<float>(random.NextInt(1000) + 12);
+        float y = static_cast<float>(random.NextInt(680) + 10);
+        float vx = static_cast<float>(random.NextInt(200) - 100);
+        float vy = static_cast<float>(random.NextInt(200) - 100);
+        balls.Spawn(x, y, vx, vy);
+    }
+}
+
+double Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+    const int ballCounts[] = {1000, 10000, 100000};
+
+    printf("%8s %12s %12s %12s %12s %10s %8s\n", "balls", "contacts", "brute ms", "grid ms", "resolve ms", "speedup", "match");
+    for (int count : ballCounts) {
+        BallStore balls;
+        MakeBalls(balls, count);
+        SpatialGrid grid;
+        grid.Configure(fieldWidth, fieldHeight, cellSize, count);
+
+        auto start = std::chrono::steady_clock::now();
+        int bruteContacts = CollideBallsBruteForce(balls, ballRadius, false);
+        double bruteMs = Seconds(start) * 1000.0;
+
+        // broad phase rebuild + pair test, the per-tick cost
+        start = std::chrono::steady_clock::now();
+        grid.Build(balls);
+        int gridContacts = CollideBalls(balls, grid, ballRadius, false);
+        double gridMs = Seconds(start) * 1000.0;
+
+        // same with contact resolution
+        start = std::chrono::steady_clock::now();
+        grid.Build(balls);
+        CollideBalls(balls, grid, ballRadius, true);
+        double resolveMs = Seconds(start) * 1000.0;
+
+        printf("%8d %12d %12.3f %12.3f %12.3f %10.1f %8s\n", count, gridContacts, bruteMs, gridMs, resolveMs,
+               bruteMs / gridMs, gridContacts == bruteContacts ? "yes" : "NO");
+    }
+    return 0;
+}
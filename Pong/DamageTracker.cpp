@@ -0,0 +1,163 @@
+#include "DamageTracker.h"
+
+// Extra (undamaged) pixels a merge may add before the rects are kept apart
+const Sint64 mergeSlack = 512;
+
+static Sint64 Area(const SDL_Rect& rect) {
+    return static_cast<Sint64>(rect.w) * rect.h;
+}
+
+static SDL_Rect Union(const SDL_Rect& a, const SDL_Rect& b) {
+    int x0 = a.x < b.x ? a.x : b.x;
+    int y0 = a.y < b.y ? a.y : b.y;
+    int x1 = a.x + a.w > b.x + b.w ? a.x + a.w : b.x + b.w;
+    int y1 = a.y + a.h > b.y + b.h ? a.y + a.h : b.y + b.h;
+    return {x0, y0, x1 - x0, y1 - y0};
+}
+
+static Sint64 OverlapArea(const SDL_Rect& a, const SDL_Rect& b) {
+    int w = (a.x + a.w < b.x + b.w ? a.x + a.w : b.x + b.w) - (a.x > b.x ? a.x : b.x);
+    int h = (a.y + a.h < b.y + b.h ? a.y + a.h : b.y + b.h) - (a.y > b.y ? a.y : b.y);
+    return w > 0 && h > 0 ? static_cast<Sint64>(w) * h : 0;
+}
+
+static bool Contains(const SDL_Rect& outer, const SDL_Rect& inner) {
+    return inner.x >= outer.x && inner.y >= outer.y && inner.x + inner.w <= outer.x + outer.w &&
+           inner.y + inner.h <= outer.y + outer.h;
+}
+
+DamageTracker::DamageTracker() {
+    mWidth = 0;
+    mHeight = 0;
+    mMaxRects = 32;
+    mDirtyPixels = 0;
+    mLastHit = 0;
+    mFull = false;
+    mFullRequested = true;
+}
+
+void DamageTracker::Configure(int width, int height, int maxRects) {
+    mWidth = width;
+    mHeight = height;
+    mMaxRects = maxRects;
+    mPrevious.clear();
+    mCurrent.clear();
+    mDirty.reserve(maxRects);
+    mFullRequested = true;
+}
+
+void DamageTracker::BeginFrame() {
+    mPrevious.swap(mCurrent);
+    mCurrent.clear();
+    mDirty.clear();
+    mDirtyPixels = 0;
+    mLastHit = 0;
+    mFull = false;
+}
+
+void DamageTracker::Finish() {
+    mFull = mFullRequested;
+    mFullRequested = false;
+    size_t common = mPrevious.size() < mCurrent.size() ? mPrevious.size() : mCurrent.size();
+    for (size_t i = 0; i < common && !mFull; i++) {
+        const SDL_Rect& before = mPrevious[i];
+        const SDL_Rect& now = mCurrent[i];
+        if (before.x != now.x || before.y != now.y || before.w != now.w || before.h != now.h) {
+            Damage(before);
+            Damage(now);
+        }
+    }
+    // objects that appeared or went away
+    for (size_t i = common; i < mPrevious.size() && !mFull; i++) {
+        Damage(mPrevious[i]);
+    }
+    for (size_t i = common; i < mCurrent.size() && !mFull; i++) {
+        Damage(mCurrent[i]);
+    }
+
+    if (mFull) {
+        mDirty.clear();
+        mDirty.push_back({0, 0, mWidth, mHeight});
+        mDirtyPixels = static_cast<Uint64>(mWidth) * mHeight;
+    }
+}
+
+void DamageTracker::Damage(SDL_Rect rect) {
+    // clip to the screen (balls leave it)
+    if (rect.x < 0) {
+        rect.w += rect.x;
+        rect.x = 0;
+    }
+    if (rect.y < 0) {
+        rect.h += rect.y;
+        rect.y = 0;
+    }
+    if (rect.x + rect.w > mWidth) {
+        rect.w = mWidth - rect.x;
+    }
+    if (rect.y + rect.h > mHeight) {
+        rect.h = mHeight - rect.y;
+    }
+    if (rect.w <= 0 || rect.h <= 0) {
+        return;
+    }
+
+    // already covered: the common case once many objects share a region
+    // (the rect that took the last one is the likeliest)
+    if (mLastHit < static_cast<int>(mDirty.size()) && Contains(mDirty[mLastHit], rect)) {
+        return;
+    }
+    for (int i = 0; i < static_cast<int>(mDirty.size()); i++) {
+        if (Contains(mDirty[i], rect)) {
+            mLastHit = i;
+            return;
+        }
+    }
+
+    // grow the rect that takes it for the fewest extra pixels
+    int best = -1;
+    Sint64 bestCost = 0;
+    for (int i = 0; i < static_cast<int>(mDirty.size()); i++) {
+        const SDL_Rect& dirty = mDirty[i];
+        Sint64 cost = Area(Union(dirty, rect)) - Area(dirty) - Area(rect) + OverlapArea(dirty, rect);
+        if (best < 0 || cost < bestCost) {
+            best = i;
+            bestCost = cost;
+        }
+    }
+    int grown;
+    if (best >= 0 && (bestCost <= mergeSlack || static_cast<int>(mDirty.size()) >= mMaxRects)) {
+        mDirty[best] = Union(mDirty[best], rect);
+        grown = best;
+    } else {
+        mDirty.push_back(rect);
+        grown = static_cast<int>(mDirty.size()) - 1;
+    }
+    // keep the rects disjoint, so every pixel is repainted (and counted) once:
+    // the new or grown rect swallows every rect it now overlaps
+    for (int i = 0; i < static_cast<int>(mDirty.size());) {
+        if (i == grown || OverlapArea(mDirty[grown], mDirty[i]) == 0) {
+            i++;
+            continue;
+        }
+        mDirty[grown] = Union(mDirty[grown], mDirty[i]);
+        int last = static_cast<int>(mDirty.size()) - 1;
+        mDirty[i] = mDirty[last];
+        if (grown == last) {
+            grown = i;
+        }
+        mDirty.pop_back();
+        // the union may reach rects already passed
+        i = 0;
+    }
+    mLastHit = grown;
+    mDirtyPixels = 0;
+    for (const SDL_Rect& dirty : mDirty) {
+        mDirtyPixels += Area(dirty);
+    }
+
+    // past half the screen, repainting all of it is about as cheap
+    if (mDirtyPixels * 2 > static_cast<Uint64>(mWidth) * mHeight) {
+        mFull = true;
+    }
+}
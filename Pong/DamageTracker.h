@@ -0,0 +1,54 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Works out which parts of the screen have to be repainted. Each frame the
+// moving objects report their bounds in draw order; an object whose bounds
+// differ from last frame's (matched by position in that order) damages both its
+// old and new rectangle, and objects that went away damage their old one.
+// The damage is merged into at most maxRects disjoint rectangles (so no pixel
+// is repainted or counted twice), and becomes the whole
+// screen once it covers more than half of it (one big copy is then cheaper).
+class DamageTracker {
+public:
+    DamageTracker();
+    // Screen size and rect budget (also damages the whole screen)
+    void Configure(int width, int height, int maxRects = 32);
+    // Pre-size for this many objects per frame
+    void Reserve(int objects) {
+        mPrevious.reserve(objects);
+        mCurrent.reserve(objects);
+    }
+    // Forces a full repaint next frame (first frame, background changed)
+    void DamageAll() { mFullRequested = true; }
+    // Starts a frame: this frame's bounds become the previous ones
+    void BeginFrame();
+    // Bounds of the next moving object this frame
+    void AddObject(const SDL_Rect& bounds) { mCurrent.push_back(bounds); }
+    // Compares with the previous frame and merges the damage
+    void Finish();
+
+    // Rectangles to repaint (the whole screen if IsFull)
+    const std::vector<SDL_Rect>& GetDirtyRects() const { return mDirty; }
+    bool IsFull() const { return mFull; }
+    // Area of the dirty rectangles (they never overlap)
+    Uint64 GetDirtyPixels() const { return mDirtyPixels; }
+
+private:
+    // Adds a rectangle to the dirty set, growing an existing one if it costs
+    // little extra area; rects it then overlaps are merged into it
+    void Damage(SDL_Rect rect);
+
+    int mWidth;
+    int mHeight;
+    int mMaxRects;
+    std::vector<SDL_Rect> mPrevious;
+    std::vector<SDL_Rect> mCurrent;
+    std::vector<SDL_Rect> mDirty;
+    Uint64 mDirtyPixels;
+    // dirty rect that took the last damage (checked first)
+    int mLastHit;
+    // result of the last Finish, and a full repaint asked for the next one
+    bool mFull;
+    bool mFullRequested;
+};
@@ -0,0 +1,86 @@
+#include "FramePacer.h"
+
+// Clamp maximum delta time value (never jump ahead too far)
+const float maxDeltaTime = 0.05f;
+
+FramePacer::FramePacer(int targetFps) {
+    mFrequency = SDL_GetPerformanceFrequency();
+    mStats = {};
+    SetTargetFps(targetFps);
+    Reset();
+}
+
+void FramePacer::SetTargetFps(int targetFps) {
+    if (targetFps < 1) {
+        targetFps = 1;
+    }
+    mTargetFps = targetFps;
+    mPeriod = mFrequency / targetFps;
+    // start by spinning the last 2ms of every frame
+    mSpinMargin = mFrequency / 500;
+}
+
+double FramePacer::GetFrameBudgetMs() const {
+    return ToMs(mPeriod);
+}
+
+void FramePacer::Reset() {
+    mFrameStart = SDL_GetPerformanceCounter();
+    mNextFrame = mFrameStart + mPeriod;
+}
+
+float FramePacer::WaitForNextFrame() {
+    Uint64 now = SDL_GetPerformanceCounter();
+    mStats.workMs = ToMs(now - mFrameStart);
+    mStats.sleepMs = 0.0;
+    mStats.spinMs = 0.0;
+    mStats.droppedFrames = 0;
+
+    // sleep through most of the remaining budget
+    if (now + mSpinMargin < mNextFrame) {
+        Uint64 wakeAt = mNextFrame - mSpinMargin;
+        Uint32 sleepMs = static_cast<Uint32>((wakeAt - now) * 1000 / mFrequency);
+        if (sleepMs > 0) {
+            SDL_Delay(sleepMs);
+            Uint64 woke = SDL_GetPerformanceCounter();
+            mStats.sleepMs = ToMs(woke - now);
+            // overslept by more than half the spin window: widen it so the next frames wake earlier
+            if (woke > wakeAt && woke - wakeAt > mSpinMargin / 2) {
+                mSpinMargin = 2 * (woke - wakeAt);
+                if (mSpinMargin > mPeriod / 2) {
+                    mSpinMargin = mPeriod / 2;
+                }
+            }
+            now = woke;
+        }
+    }
+
+    // finish with a short high-resolution wait
+    Uint64 spinStart = now;
+    while (now < mNextFrame) {
+        now = SDL_GetPerformanceCounter();
+    }
+    mStats.spinMs = ToMs(now - spinStart);
+    mStats.overshootMs = ToMs(now - mNextFrame);
+
+    // Delta time is the difference between frame starts (converted to seconds)
+    float deltaTime = static_cast<float>(now - mFrameStart) / mFrequency;
+    if (deltaTime > maxDeltaTime) {
+        deltaTime = maxDeltaTime;
+    }
+    mStats.deltaTime = deltaTime;
+    mFrameStart = now;
+
+    // advance the deadline on the ideal timeline (corrects drift), but if we fell
+    // a whole frame behind start a new timeline instead of bursting to catch up
+    mNextFrame += mPeriod;
+    if (now >= mNextFrame) {
+        mStats.droppedFrames = static_cast<int>((now - mNextFrame) / mPeriod) + 1;
+        mNextFrame = now + mPeriod;
+    }
+    return deltaTime;
+}
+
+double FramePacer::ToMs(Uint64 counter) const {
+    return static_cast<double>(counter) * 1000.0 / mFrequency;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <SDL2/SDL.h>
+
+// Timing of the most recent frame (all times in milliseconds)
+struct FrameStats {
+    float deltaTime;    // seconds between the last two frame starts (clamped)
+    double workMs;      // time from the previous frame start until the pacer was called
+    double sleepMs;     // time handed back to the OS with SDL_Delay
+    double spinMs;      // high-resolution wait after waking up
+    double overshootMs; // how late the frame started compared to its deadline
+    int droppedFrames;  // deadlines skipped because the frame ran too long
+};
+
+// Paces the game loop to a target frame rate without burning a core.
+// Sleeps for most of the remaining frame budget and spins for the last
+// sliver; deadlines advance by exactly one period so rounding and oversleep
+// don't accumulate into drift.
+class FramePacer {
+public:
+    FramePacer(int targetFps = 60);
+    // Change the frame rate (takes effect from the next frame)
+    void SetTargetFps(int targetFps);
+    int GetTargetFps() const { return mTargetFps; }
+    // Frame budget in milliseconds
+    double GetFrameBudgetMs() const;
+    // Start a new timeline (call right before entering the loop)
+    void Reset();
+    // Blocks until the next frame is due and returns its delta time in seconds
+    float WaitForNextFrame();
+    const FrameStats& GetStats() const { return mStats; }
+
+private:
+    double ToMs(Uint64 counter) const;
+
+    int mTargetFps;
+    Uint64 mFrequency;  // performance counter ticks per second
+    Uint64 mPeriod;     // performance counter ticks per frame
+    Uint64 mNextFrame;  // deadline of the next frame
+    Uint64 mFrameStart; // start of the current frame
+    // remaining time below which we spin instead of sleeping
+    // (grows with the worst oversleep seen, SDL_Delay can be coarse)
+    Uint64 mSpinMargin;
+    FrameStats mStats;
+};
@@ -1,14 +1,36 @@
 #include "Game.h"
+#include "BallKernel.h"
+#include "../Common/Profiler.h"
+#include <thread>
 
 const int thickness = 15;
 const float paddleH = 100.0f;
 const float windowWidth = 1024;
 const float windowHeight = 700;
+// Balls per job when the update runs on the job system
+const int ballChunkSize = 16384;
+// Broad phase cell size (at least one ball across)
+const float gridCellSize = 16.0f;
 
-Game::Game() {
+Game::Game(int ballCount, int ballCapacity, Uint64 seed) {
     mWindow = nullptr;
+    mRenderer = nullptr;
     mIsRunning = true;
-    mTicksCount = 0;
+    mShowPacerOverlay = false;
+    mHeadless = false;
+    mEndOnMiss = true;
+    mBurstMode = false;
+    mJobs = nullptr;
+    mBallCollisions = false;
+    mRecording = false;
+    mRecordDeltaTime = 0.0f;
+    mRasterizer = nullptr;
+    mDamageTracking = false;
+    mBackground = nullptr;
+    mPixelsTouched = 0;
+    mRenderThread = false;
+    mInputDir1 = 0;
+    mInputDir2 = 0;
 
     // paddle 1
     mPaddleDir1 = 0;
@@ -21,20 +43,43 @@ Game::Game() {
     mPaddlePos2.y = windowHeight / 2.0f;
 
     // ball
-    srand(time(NULL));
-    float vecX, vecY;
-    for (int i = 0; i < numBalls; i++) {
-        // each ball start with the center with different velocity
-        vecX = rand() % 40 + 70;
-        vecY = rand() % 40 + 70;
-        if (rand() % 2 == 0) {
-            vecX *= -1;
-        }
-        if (rand() % 2 == 0) {
-            vecY *= -1;
-        }
-        balls.push_back({windowWidth / 2.0f, windowHeight / 2.0f, vecX, vecY});
+    mBalls.Reserve(ballCapacity > ballCount ? ballCapacity : ballCount);
+    // walls, center line, paddles, every ball and the overlay bars
+    mBatcher.Reserve(mBalls.Capacity() + 9);
+    mSeed = seed != 0 ? seed : static_cast<Uint64>(time(NULL));
+    mRandom.Seed(mSeed);
+    mInitialBallCount = ballCount;
+    for (int i = 0; i < ballCount; i++) {
+        ServeBall();
+    }
+}
+
+BallId Game::ServeBall() {
+    // each ball start with the center with different velocity
+    float vecX = mRandom.NextInt(40) + 70;
+    float vecY = mRandom.NextInt(40) + 70;
+    if (mRandom.NextInt(2) == 0) {
+        vecX *= -1;
+    }
+    if (mRandom.NextInt(2) == 0) {
+        vecY *= -1;
+    }
+    return mBalls.Spawn(windowWidth / 2.0f, windowHeight / 2.0f, vecX, vecY);
+}
+
+BallId Game::SpawnBall(float posX, float posY, float vecX, float vecY) {
+    return mBalls.Spawn(posX, posY, vecX, vecY);
+}
+
+void Game::RetireBall(BallId id) {
+    mBalls.Retire(id);
+}
+
+void Game::SetBallCollisions(bool collide) {
+    if (collide && !mBallCollisions) {
+        mGrid.Configure(windowWidth, windowHeight, gridCellSize, mBalls.Capacity());
     }
+    mBallCollisions = collide;
 }
 
 bool Game::Initialize() {
@@ -62,10 +107,16 @@ bool Game::Initialize() {
     }
 
     // create render after window created
-    mRenderer = SDL_CreateRenderer(
-        mWindow,                                               // Window to create renderer for
-        -1,                                                    // specifies which graphics driver to use; -1 only a single window [let SDL decide]
-        SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC); // initialization flags
+    if (mDamageTracking) {
+        // draws straight into the window surface, which keeps last frame's
+        // pixels, so only the damaged parts need repainting and updating
+        mRenderer = SDL_CreateSoftwareRenderer(SDL_GetWindowSurface(mWindow));
+    } else {
+        mRenderer = SDL_CreateRenderer(
+            mWindow,                                               // Window to create renderer for
+            -1,                                                    // specifies which graphics driver to use; -1 only a single window [let SDL decide]
+            SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC); // initialization flags
+    }
 
     if (!mRenderer) {
         SDL_Log("Failed to create renderer: %s", SDL_GetError());
@@ -76,22 +127,197 @@ bool Game::Initialize() {
     return true;
 }
 
+bool Game::InitializeHeadless(SDL_Renderer* renderer) {
+    // simulation only needs timing from the caller, so SDL is never initialized
+    // (an offscreen renderer can be passed in to also run GenerateOutput)
+    mRenderer = renderer;
+    mHeadless = true;
+    mEndOnMiss = false;
+    mIsRunning = true;
+    return true;
+}
+
 void Game::RunLoop() {
+    // first frame is measured from here
+    mPacer.Reset();
+    if (mRenderThread && !mDamageTracking && !mRasterizer) {
+        RunThreaded();
+        return;
+    }
     // run iterations of gameloop until mIsRunning == false
     while (mIsRunning) {
         ProcessInput();
         UpdateGame();
         GenerateOutput();
+        PROFILE_END_FRAME();
+    }
+}
+
+void Game::SetRenderThread(bool enabled) {
+    mRenderThread = enabled;
+    if (enabled) {
+        for (RenderBatcher& frame : mRenderFrames) {
+            frame.Reserve(mBalls.Capacity() + 9);
+        }
+    }
+}
+
+void Game::RunThreaded() {
+    mFrameMailbox.Reset();
+    for (RenderBatcher& frame : mRenderFrames) {
+        frame.SetImmediate(mBatcher.IsImmediate());
+    }
+    std::thread simulation(&Game::SimulationLoop, this);
+    // this thread created the window: events and drawing stay here
+    while (mIsRunning) {
+        ProcessInput();
+        PresentFrame();
+        PROFILE_END_FRAME();
+    }
+    simulation.join();
+
+    FrameMailboxStats stats = mFrameMailbox.GetStats();
+    SDL_Log("Render thread: %llu frames published, %llu presented, %llu dropped, %llu duplicated, "
+            "latency %.2f ms avg, %.2f ms max",
+            static_cast<unsigned long long>(stats.published), static_cast<unsigned long long>(stats.presented),
+            static_cast<unsigned long long>(stats.dropped), static_cast<unsigned long long>(stats.duplicated),
+            stats.averageLatencyMs, stats.maxLatencyMs);
+}
+
+void Game::SimulationLoop() {
+    while (mIsRunning) {
+        UpdateGame();
+        // record the tick's scene for the render thread (the buffer may come
+        // back unflushed when the render thread skipped its frame)
+        RenderBatcher& frame = mRenderFrames[mFrameMailbox.GetWriteIndex()];
+        frame.Clear();
+        AddStaticRects(frame);
+        AddMovingRects(frame);
+        if (mShowPacerOverlay) {
+            DrawPacerOverlay(frame);
+        }
+        mFrameMailbox.Publish();
+    }
+}
+
+void Game::PresentFrame() {
+    PROFILE_SCOPE("Game::PresentFrame");
+    // wait up to a frame for the simulation; with nothing new the screen
+    // keeps showing the last frame (and events are polled again)
+    int index;
+    {
+        PROFILE_SCOPE("FrameMailbox::Acquire");
+        index = mFrameMailbox.Acquire(mPacer.GetFrameBudgetMs());
+    }
+    if (index < 0) {
+        return;
+    }
+    SDL_SetRenderDrawColor(mRenderer, 20, 100, 20, 255);
+    SDL_RenderClear(mRenderer);
+    {
+        PROFILE_SCOPE("RenderBatcher::Flush");
+        mRenderFrames[index].Flush(mRenderer);
+    }
+    PROFILE_SCOPE("SDL_RenderPresent");
+    SDL_RenderPresent(mRenderer);
+}
+
+int Game::RunHeadless(int ticks, float deltaTime, const std::vector<PaddleInput>& script) {
+    int tick = 0;
+    for (; tick < ticks && mIsRunning; tick++) {
+        // scripted input replaces ProcessInput
+        if (!script.empty()) {
+            const PaddleInput& input = script[tick % script.size()];
+            mPaddleDir1 = input.dir1;
+            mPaddleDir2 = input.dir2;
+        }
+        // a recording must keep the step it was started with
+        UpdateSimulation(mRecording ? mRecordDeltaTime : deltaTime);
+        RecordTick();
+        if (mRenderer || mRasterizer) {
+            GenerateOutput();
+        }
+        PROFILE_END_FRAME();
     }
+    return tick;
+}
+
+void Game::StartRecording(float deltaTime, bool withHashes) {
+    InputLogHeader header;
+    header.seed = mSeed;
+    header.ballCount = mInitialBallCount;
+    header.ballCapacity = mBalls.Capacity();
+    header.burstMode = mBurstMode;
+    header.ballCollisions = mBallCollisions;
+    header.endOnMiss = mEndOnMiss;
+    header.deltaTime = deltaTime;
+    // an hour at 60 ticks/s before the log has to grow
+    mInputLog.Begin(header, withHashes, 60 * 60 * 60);
+    mRecordDeltaTime = deltaTime;
+    mRecording = true;
+}
+
+int Game::RunReplay(const InputLog& log) {
+    const InputLogHeader& header = log.GetHeader();
+    mBurstMode = header.burstMode;
+    SetBallCollisions(header.ballCollisions);
+    // a windowed recording ends on the tick a ball goes out
+    mEndOnMiss = header.endOnMiss;
+
+    for (int tick = 0; tick < log.GetTickCount(); tick++) {
+        PaddleInput input = log.GetInput(tick);
+        mPaddleDir1 = input.dir1;
+        mPaddleDir2 = input.dir2;
+        UpdateSimulation(header.deltaTime);
+        if (log.HasHashes() && StateHash() != log.GetHash(tick)) {
+            return tick;
+        }
+        if (!mIsRunning) {
+            // the game is over: so was the recording, unless it has ticks left
+            return tick + 1 < log.GetTickCount() ? tick : -1;
+        }
+    }
+    return -1;
+}
+
+Uint64 Game::StateHash() const {
+    // FNV-1a over 64-bit words
+    Uint64 hash = 14695981039346656037ULL;
+    auto mix = [&hash](Uint64 value) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+    auto bits = [](float value) {
+        Uint32 word;
+        memcpy(&word, &value, sizeof(word));
+        return static_cast<Uint64>(word);
+    };
+
+    mix(bits(mPaddlePos1.y) << 32 | bits(mPaddlePos2.y));
+    mix(static_cast<Uint64>(mBalls.Count()));
+    for (int i = 0; i < mBalls.Count(); i++) {
+        mix(bits(mBalls.x[i]) << 32 | bits(mBalls.y[i]));
+        mix(bits(mBalls.vx[i]) << 32 | bits(mBalls.vy[i]));
+    }
+    return hash;
 }
 
 void Game::Shutdown() {
+    PROFILE_WRITE_REPORTS("pong_profile");
+    if (mBackground) {
+        SDL_DestroyTexture(mBackground);
+        mBackground = nullptr;
+    }
+    if (mHeadless) { // nothing was created (the caller owns an offscreen renderer)
+        return;
+    }
     SDL_DestroyRenderer(mRenderer); // destory renderer
     SDL_DestroyWindow(mWindow);     // destory window
     SDL_Quit();                     // closes SDL
 }
 
 void Game::ProcessInput() {
+    PROFILE_SCOPE("Game::ProcessInput");
     SDL_Event event;
     // While there are still events in the queue
     while (SDL_PollEvent(&event)) {
@@ -100,6 +326,11 @@ void Game::ProcessInput() {
         case SDL_QUIT:
             mIsRunning = false;
             break;
+        case SDL_KEYDOWN:
+            if (event.key.keysym.sym == SDLK_F1 && !event.key.repeat) {
+                mShowPacerOverlay = !mShowPacerOverlay;
+            }
+            break;
         }
     }
 
@@ -110,37 +341,56 @@ void Game::ProcessInput() {
         mIsRunning = false;
     }
 
-    // updates mPaddleDir based on input
-    // add/subtract from mPaddleDir ensures that if both keys pressed mPaddleDir is zero
-    mPaddleDir1 = 0;
+    // updates the paddle directions based on input
+    // add/subtract ensures that if both keys pressed the direction is zero
+    // (the next tick picks them up, possibly on the simulation thread)
+    int dir1 = 0;
     if (state[SDL_SCANCODE_W]) {
-        mPaddleDir1 -= 1;
+        dir1 -= 1;
     }
     if (state[SDL_SCANCODE_S]) {
-        mPaddleDir1 += 1;
+        dir1 += 1;
     }
+    mInputDir1.store(dir1, std::memory_order_relaxed);
 
-    mPaddleDir2 = 0;
+    int dir2 = 0;
     if (state[SDL_SCANCODE_UP]) {
-        mPaddleDir2 -= 1;
+        dir2 -= 1;
     }
     if (state[SDL_SCANCODE_DOWN]) {
-        mPaddleDir2 += 1;
+        dir2 += 1;
     }
+    mInputDir2.store(dir2, std::memory_order_relaxed);
 }
 
 void Game::UpdateGame() {
-    // Wait until 16ms has elapsed since last frame
-    while (!SDL_TICKS_PASSED(SDL_GetTicks(), mTicksCount + 16))
-        ;
-    // Delta time is the difference in ticks from last frame
-    // (converted to seconds)
-    float deltaTime = (SDL_GetTicks() - mTicksCount) / 1000.0f;
-    // Clamp maximum delta time value (never jump ahead too far)
-    if (deltaTime > 0.05f) {
-        deltaTime = 0.05f;
+    PROFILE_SCOPE("Game::UpdateGame");
+    // Sleep until the next frame is due
+    // (delta time is measured between frame starts and already clamped)
+    float deltaTime;
+    {
+        PROFILE_SCOPE("FramePacer::WaitForNextFrame");
+        deltaTime = mPacer.WaitForNextFrame();
+    }
+    // recorded games step by a fixed amount so replays match exactly
+    if (mRecording) {
+        deltaTime = mRecordDeltaTime;
+    }
+
+    mPaddleDir1 = mInputDir1.load(std::memory_order_relaxed);
+    mPaddleDir2 = mInputDir2.load(std::memory_order_relaxed);
+    UpdateSimulation(deltaTime);
+    RecordTick();
+}
+
+void Game::RecordTick() {
+    if (mRecording) {
+        mInputLog.Append({mPaddleDir1, mPaddleDir2}, mInputLog.HasHashes() ? StateHash() : 0);
     }
+}
 
+void Game::UpdateSimulation(float deltaTime) {
+    PROFILE_SCOPE("Game::UpdateSimulation");
     // Update paddle1
     if (mPaddleDir1 != 0) {
         mPaddlePos1.y += mPaddleDir1 * 200.0f * deltaTime; // 200 pixels/second
@@ -163,66 +413,134 @@ void Game::UpdateGame() {
         }
     }
 
-    // Update ball
-    for (int i = 0; i < numBalls; i++) {
-        balls[i].Pos.x += balls[i].Vec.x * deltaTime;
-        balls[i].Pos.y += balls[i].Vec.y * deltaTime;
+    // Update balls: integrate, bounce off walls/paddles and flag balls that left the screen
+    // (one fused pass over the ball arrays, see BallKernel.cpp)
+    BallKernelParams params;
+    params.deltaTime = deltaTime;
+    params.paddle1Y = mPaddlePos1.y;
+    params.paddle2Y = mPaddlePos2.y;
+    params.paddleHalfH = paddleH / 2.0f;
+    params.wallTop = thickness;
+    params.wallBottom = windowHeight - thickness;
+    params.paddle1MinX = 20.0f;
+    params.paddle1MaxX = 25.0f;
+    params.paddle2MinX = windowWidth - 25.0f;
+    params.paddle2MaxX = windowWidth - 20.0f;
+    params.ballHalf = thickness / 2;
+    params.fieldWidth = windowWidth;
+    int numBalls = mBalls.Count();
+    int outCount = 0;
+    if (mJobs) {
+        // every ball is independent, so chunks can run in any order on any thread
+        std::atomic<int> chunkOut(0);
+        mJobs->ParallelFor(numBalls, ballChunkSize, [&](int begin, int end) {
+            PROFILE_SCOPE("UpdateBalls chunk");
+            chunkOut.fetch_add(UpdateBalls(mBalls, begin, end, params));
+        });
+        outCount = chunkOut.load();
+    } else {
+        PROFILE_SCOPE("UpdateBalls");
+        outCount = UpdateBalls(mBalls, 0, numBalls, params);
     }
 
-    // check for collision and update velocity
-    // (prevent the ball from not moving far enough and constantly negating velocity and getting stuck)
-    for (int i = 0; i < numBalls; i++) {
-        if (balls[i].Pos.y <= thickness && balls[i].Vec.y < 0.0f) { // if collide with top wall && moving up
-            balls[i].Vec.y *= -1;
-        } else if (balls[i].Pos.y >= windowHeight - thickness && balls[i].Vec.y > 0.0f) { // bottom wall
-            balls[i].Vec.y *= -1;
-        }
+    if (mBallCollisions) {
+        PROFILE_SCOPE("Ball collisions");
+        // bucket balls into the grid, then resolve contacts between neighbors only
+        mGrid.Build(mBalls);
+        CollideBalls(mBalls, mGrid, thickness / 2.0f, true);
+        // balls pushed by other balls can skip the kernel's thin paddle strip,
+        // so test against the whole paddle rectangle as well
+        CollidePaddle(mBalls, mGrid, thickness / 2.0f, mPaddlePos1.x, mPaddlePos1.y, thickness / 2.0f, paddleH / 2.0f);
+        CollidePaddle(mBalls, mGrid, thickness / 2.0f, mPaddlePos2.x, mPaddlePos2.y, thickness / 2.0f, paddleH / 2.0f);
     }
-    // DEBUGGING: force ball to stay on screen
-    // for (int i = 0; i < numBalls; i++) {
-    //     if (balls[i].Pos.x <= thickness && balls[i].Vec.x < 0.0f) { // if collide with top wall && moving up
-    //         balls[i].Vec.x *= -1;
-    //     } else if (balls[i].Pos.x >= windowWidth - thickness && balls[i].Vec.x > 0.0f) { // bottom wall
-    //         balls[i].Vec.x *= -1;
-    //     }
-    // }
 
-    // collision with paddle1
-    for (int i = 0; i < numBalls; i++) {
-        float diff1 = std::abs(balls[i].Pos.y - mPaddlePos1.y);
-        if (
-            // if absolute y distance from paddle is less than half the height of paddle
-            diff1 <= paddleH / 2.0f &&
-            // and ball is at the correct x-position
-            balls[i].Pos.x <= 25.0f && balls[i].Pos.x >= 20.0f &&
-            // and ball is moving to the left
-            balls[i].Vec.x < 0.0f) {
-            balls[i].Vec.x *= -1.0f;
+    if (mBurstMode) {
+        // walk backwards so swap-and-pop only moves balls that were already handled
+        // (split balls are appended past numBalls and skipped)
+        for (int i = numBalls - 1; i >= 0; i--) {
+            if (mBalls.flags[i] & kBallOut) { // expire
+                mBalls.RetireAt(i);
+            } else if (mBalls.flags[i] & kBallHitPaddle) { // split, mirrored vertically
+                mBalls.Spawn(mBalls.x[i], mBalls.y[i], mBalls.vx[i], -mBalls.vy[i]);
+            }
         }
-    }
-    // collision with paddle2
-    for (int i = 0; i < numBalls; i++) {
-        float diff2 = std::abs(balls[i].Pos.y - mPaddlePos2.y);
-        if (
-            // if absolute y distance from paddle is less than half the height of paddle
-            diff2 <= paddleH / 2.0f &&
-            // and ball is at the correct x-position
-            balls[i].Pos.x >= (windowWidth - 25.0f) && balls[i].Pos.x <= (windowWidth - 20.0f) &&
-            // and ball is moving to the right
-            balls[i].Vec.x > 0.0f) {
-            balls[i].Vec.x *= -1.0f;
+        // keep at least one ball in play
+        if (mBalls.Count() == 0) {
+            ServeBall();
         }
+        return;
     }
 
-    // // end game if offscreen
+    // end game if offscreen
+    if (outCount == 0) {
+        return;
+    }
+    if (mEndOnMiss) {
+        mIsRunning = false;
+        return;
+    }
     for (int i = 0; i < numBalls; i++) {
-        if ((balls[i].Pos.x - thickness / 2) < 0 || (balls[i].Pos.x + thickness / 2) > windowWidth) {
-            mIsRunning = false;
+        if (mBalls.flags[i] & kBallOut) { // serve again from the center towards the other side
+            mBalls.x[i] = windowWidth / 2.0f;
+            mBalls.y[i] = windowHeight / 2.0f;
+            mBalls.vx[i] *= -1.0f;
         }
     }
 }
 
 void Game::GenerateOutput() {
+    PROFILE_SCOPE("Game::GenerateOutput");
+    mPixelsTouched = 0;
+    if (mRasterizer) {
+        // the same scene, recorded into the rasterizer and drawn tile by tile
+        mRasterizer->Clear(0xFF146414);
+        mPixelsTouched += static_cast<Uint64>(windowWidth) * static_cast<Uint64>(windowHeight);
+        AddStaticRects(mBatcher);
+        AddMovingRects(mBatcher);
+        if (mShowPacerOverlay) {
+            DrawPacerOverlay(mBatcher);
+        }
+        {
+            PROFILE_SCOPE("RenderBatcher::Flush");
+            mBatcher.Flush(*mRasterizer);
+        }
+        PROFILE_SCOPE("TiledRasterizer::Execute");
+        mRasterizer->Execute();
+        return;
+    }
+    if (mDamageTracking && (mBackground || CreateBackground())) {
+        // moving objects first, so their bounds are known before repainting
+        mDamage.BeginFrame();
+        AddMovingRects(mBatcher);
+        if (mShowPacerOverlay) {
+            DrawPacerOverlay(mBatcher);
+        }
+        mDamage.Finish();
+
+        // restore the static scene under everything that moved...
+        const std::vector<SDL_Rect>& dirty = mDamage.GetDirtyRects();
+        for (const SDL_Rect& rect : dirty) {
+            SDL_RenderCopy(mRenderer, mBackground, &rect, &rect);
+        }
+        mPixelsTouched += mDamage.GetDirtyPixels();
+        // ...and draw the moving objects over it (those that didn't move
+        // repaint the same pixels, but one may overlap a dirty rect)
+        {
+            PROFILE_SCOPE("RenderBatcher::Flush");
+            mBatcher.Flush(mRenderer);
+        }
+
+        // present only the dirty rects
+        PROFILE_SCOPE("SDL_UpdateWindowSurfaceRects");
+        if (mWindow) {
+            SDL_RenderFlush(mRenderer);
+            SDL_UpdateWindowSurfaceRects(mWindow, dirty.data(), static_cast<int>(dirty.size()));
+        } else {
+            SDL_RenderPresent(mRenderer);
+        }
+        return;
+    }
+
     // clear back buffer to a color
     SDL_SetRenderDrawColor( // specify a color (blue)
         mRenderer,          // pointer to renderer
@@ -232,9 +550,28 @@ void Game::GenerateOutput() {
         255                 // A
     );
     SDL_RenderClear(mRenderer); // clear the back buffer to the current draw color
+    mPixelsTouched += static_cast<Uint64>(windowWidth) * static_cast<Uint64>(windowHeight);
 
     // draw the entire game scene
-    SDL_SetRenderDrawColor(mRenderer, 255, 255, 255, 255); // set draw color to white
+    // (everything is collected by mBatcher and drawn with one call per color)
+    AddStaticRects(mBatcher);
+    AddMovingRects(mBatcher);
+
+    if (mShowPacerOverlay) {
+        DrawPacerOverlay(mBatcher);
+    }
+    {
+        PROFILE_SCOPE("RenderBatcher::Flush");
+        mBatcher.Flush(mRenderer);
+    }
+
+    // swap the front and back buffers
+    PROFILE_SCOPE("SDL_RenderPresent");
+    SDL_RenderPresent(mRenderer);
+}
+
+void Game::AddStaticRects(RenderBatcher& batcher) {
+    const SDL_Color white{255, 255, 255, 255};
     // specify bounds of the rectangle for top wall
     SDL_Rect mid{
         static_cast<int>(windowWidth) / 2 - 2, // Top left x
@@ -242,7 +579,7 @@ void Game::GenerateOutput() {
         4,                                     // Width
         static_cast<int>(windowWidth)          // Height
     };
-    SDL_RenderFillRect(mRenderer, &mid); // draw top wall
+    batcher.AddRect(mid, white); // draw top wall
     // specify bounds of the rectangle for top wall
     SDL_Rect wallTop{
         0,                             // Top left x
@@ -250,7 +587,7 @@ void Game::GenerateOutput() {
         static_cast<int>(windowWidth), // Width
         thickness                      // Height
     };
-    SDL_RenderFillRect(mRenderer, &wallTop); // draw top wall
+    batcher.AddRect(wallTop, white); // draw top wall
     // specify bounds of the rectangle for bottom wall
     SDL_Rect wallBot{
         0,                                          // Top left x
@@ -258,31 +595,116 @@ void Game::GenerateOutput() {
         static_cast<int>(windowWidth),              // Width
         thickness                                   // Height
     };
-    SDL_RenderFillRect(mRenderer, &wallBot); // draw bottom wall
+    batcher.AddRect(wallBot, white); // draw bottom wall
+    // (the center line is clipped to the window)
+    mPixelsTouched += 4 * static_cast<Uint64>(windowHeight) + 2 * static_cast<Uint64>(windowWidth) * thickness;
+}
+
+void Game::AddMovingRects(RenderBatcher& batcher) {
+    const SDL_Color white{255, 255, 255, 255};
     // draw paddle1
     SDL_Rect paddle1{
         static_cast<int>(mPaddlePos1.x - thickness / 2),
         static_cast<int>(mPaddlePos1.y - paddleH / 2),
         thickness,
         static_cast<int>(paddleH)};
-    SDL_RenderFillRect(mRenderer, &paddle1); // draw paddle1
+    batcher.AddRect(paddle1, white); // draw paddle1
     // draw paddle2
     SDL_Rect paddle2{
         static_cast<int>(mPaddlePos2.x - thickness / 2),
         static_cast<int>(mPaddlePos2.y - paddleH / 2),
         thickness,
         static_cast<int>(paddleH)};
-    SDL_RenderFillRect(mRenderer, &paddle2); // draw paddle1
+    batcher.AddRect(paddle2, white); // draw paddle1
+    if (mDamageTracking) {
+        mDamage.AddObject(paddle1);
+        mDamage.AddObject(paddle2);
+    }
     // draw ball
-    for (int i = 0; i < numBalls; i++) {
+    for (int i = 0; i < mBalls.Count(); i++) {
         SDL_Rect ball{
-            static_cast<int>(balls[i].Pos.x - thickness / 2),
-            static_cast<int>(balls[i].Pos.y - thickness / 2),
+            static_cast<int>(mBalls.x[i] - thickness / 2),
+            static_cast<int>(mBalls.y[i] - thickness / 2),
             thickness,
             thickness};
-        SDL_RenderFillRect(mRenderer, &ball); // draw ball
+        batcher.AddRect(ball, white); // draw ball
+        if (mDamageTracking) {
+            mDamage.AddObject(ball);
+        }
     }
+    mPixelsTouched += 2 * static_cast<Uint64>(thickness * paddleH) +
+                      static_cast<Uint64>(mBalls.Count()) * thickness * thickness;
+}
 
-    // swap the front and back buffers
-    SDL_RenderPresent(mRenderer);
+bool Game::CreateBackground() {
+    // the clear color with the walls and center line, drawn once
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, static_cast<int>(windowWidth),
+                                                          static_cast<int>(windowHeight), 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!surface) {
+        SDL_Log("Failed to create background: %s", SDL_GetError());
+        return false;
+    }
+    Uint32 white = SDL_MapRGBA(surface->format, 255, 255, 255, 255);
+    SDL_FillRect(surface, nullptr, SDL_MapRGBA(surface->format, 20, 100, 20, 255));
+    SDL_Rect mid{static_cast<int>(windowWidth) / 2 - 2, 0, 4, static_cast<int>(windowHeight)};
+    SDL_Rect wallTop{0, 0, static_cast<int>(windowWidth), thickness};
+    SDL_Rect wallBot{0, static_cast<int>(windowHeight) - thickness, static_cast<int>(windowWidth), thickness};
+    SDL_FillRect(surface, &mid, white);
+    SDL_FillRect(surface, &wallTop, white);
+    SDL_FillRect(surface, &wallBot, white);
+    mBackground = SDL_CreateTextureFromSurface(mRenderer, surface);
+    SDL_FreeSurface(surface);
+    if (!mBackground) {
+        SDL_Log("Failed to create background texture: %s", SDL_GetError());
+        // fall back to full redraws
+        mDamageTracking = false;
+        return false;
+    }
+    // every pixel is opaque: plain copies
+    SDL_SetTextureBlendMode(mBackground, SDL_BLENDMODE_NONE);
+    mDamage.DamageAll();
+    return true;
+}
+
+void Game::SetRasterizer(TiledRasterizer* rasterizer) {
+    mRasterizer = rasterizer;
+    if (rasterizer) {
+        mDamageTracking = false;
+    }
+}
+
+void Game::SetDamageTracking(bool enabled) {
+    // the rasterizer redraws everything
+    mDamageTracking = enabled && !mRasterizer;
+    if (mDamageTracking) {
+        // paddles, every ball and the overlay bars
+        mDamage.Configure(static_cast<int>(windowWidth), static_cast<int>(windowHeight));
+        mDamage.Reserve(mBalls.Capacity() + 6);
+    }
+}
+
+void Game::DrawPacerOverlay(RenderBatcher& batcher) {
+    // one bar per timing, scaled so the full frame budget spans 200 pixels
+    const FrameStats& stats = mPacer.GetStats();
+    const float pixelsPerMs = 200.0f / static_cast<float>(mPacer.GetFrameBudgetMs());
+    const double timings[] = {stats.workMs, stats.sleepMs, stats.spinMs, stats.overshootMs};
+    const SDL_Color colors[] = {
+        {255, 200, 0, 255}, // work (yellow)
+        {0, 150, 255, 255}, // sleep (blue)
+        {255, 0, 255, 255}, // spin (magenta)
+        {255, 0, 0, 255}    // overshoot (red)
+    };
+
+    for (int i = 0; i < 4; i++) {
+        SDL_Rect bar{
+            thickness + 5,
+            thickness + 5 + i * 8,
+            static_cast<int>(timings[i] * pixelsPerMs),
+            6};
+        batcher.AddRect(bar, colors[i], 1); // on top of the scene
+        if (mDamageTracking) {
+            mDamage.AddObject(bar);
+        }
+        mPixelsTouched += static_cast<Uint64>(bar.w > 0 ? bar.w : 0) * bar.h;
+    }
 }
\ No newline at end of file
@@ -1,15 +1,23 @@
+#include "BallStore.h"
+#include "../Common/Math.h"
+#include "DamageTracker.h"
+#include "../Common/FrameMailbox.h"
+#include "FramePacer.h"
+#include "InputLog.h"
+#include "../Common/JobSystem.h"
+#include "../Common/TiledRasterizer.h"
+#include "Random.h"
+#include "RenderBatcher.h"
+#include "SpatialGrid.h"
 #include <SDL2/SDL.h>
+#include <atomic>
 #include <cmath>
+#include <string.h>
 #include <vector>
 #include <stdio.h> 
 #include <stdlib.h>
 #include <time.h>
 
-struct Vector2 {
-    float x;
-    float y;
-};
-
 struct Ball {
     Vector2 Pos;
     Vector2 Vec;
@@ -17,11 +25,75 @@ struct Ball {
 
 class Game {
 public:
-    Game();
+    // ballCapacity is the most balls that can be alive at once
+    // (the pool is allocated here, never during the game loop)
+    // seed drives every random choice (0 picks one from the clock)
+    Game(int ballCount = 2, int ballCapacity = 0, Uint64 seed = 0);
     // Initialize the game
     bool Initialize();
+    // Initialize without a window (simulation only, unless an offscreen
+    // renderer is passed in, e.g. SDL_CreateSoftwareRenderer on a surface)
+    bool InitializeHeadless(SDL_Renderer* renderer = nullptr);
     // Runs the game loop until the game is over
     void RunLoop();
+    // Runs ticks of the simulation with a fixed delta time, feeding paddle input from script
+    // (script is looped; an empty script leaves the paddles idle)
+    // returns the number of ticks simulated
+    int RunHeadless(int ticks, float deltaTime, const std::vector<PaddleInput>& script);
+    // Frame pacing (target rate and per-frame timing stats)
+    FramePacer& GetPacer() { return mPacer; }
+
+    // Add/remove balls at runtime (SpawnBall returns kInvalidBall when the pool is full)
+    BallId SpawnBall(float posX, float posY, float vecX, float vecY);
+    void RetireBall(BallId id);
+    // Ball pool (occupancy and allocation counters)
+    const BallStore& GetBalls() const { return mBalls; }
+    // Burst mode: balls split in two on a paddle hit and expire when they leave the screen
+    void SetBurstMode(bool burst) { mBurstMode = burst; }
+    // Spread the ball update over a job system (nullptr updates on the calling thread)
+    void SetJobSystem(JobSystem* jobs) { mJobs = jobs; }
+    // Ball-ball collisions (grid broad phase; allocates the grid when first enabled)
+    void SetBallCollisions(bool collide);
+    // Record every tick's paddle input (and state hash) from now on; ticks then
+    // use the fixed deltaTime so the game can be replayed exactly.
+    // Call before the first tick (after InitializeHeadless for a headless game),
+    // the log starts from the constructed state.
+    void StartRecording(float deltaTime, bool withHashes = true);
+    bool SaveRecording(const char* fileName) const { return mInputLog.Save(fileName); }
+    // Feeds a log back through the simulation as fast as possible. The game must
+    // be constructed from the log header and initialized headless.
+    // Returns the first tick whose state hash differs from the log (-1 if none)
+    int RunReplay(const InputLog& log);
+    // Hash of paddles and every ball (bit patterns, so any divergence shows)
+    Uint64 StateHash() const;
+    Uint64 GetSeed() const { return mSeed; }
+    // Rectangle batching (draw call counts, immediate mode for comparison)
+    RenderBatcher& GetBatcher() { return mBatcher; }
+    // Repaint only what moved over a cached background instead of clearing and
+    // redrawing the whole screen. Needs a renderer whose back buffer is kept
+    // between frames: call before Initialize (which then renders in software to
+    // the window surface and presents only the dirty rects), or pass a software
+    // renderer to InitializeHeadless.
+    void SetDamageTracking(bool enabled);
+    const DamageTracker& GetDamage() const { return mDamage; }
+    // Render into a tiled software rasterizer instead of an SDL_Renderer (for
+    // machines without a GPU: pair it with InitializeHeadless; nullptr goes
+    // back to the renderer). The caller sizes it to the window, may give it a
+    // job system, and reads or dumps its framebuffer. It always redraws the
+    // whole frame, so damage tracking is turned off.
+    void SetRasterizer(TiledRasterizer* rasterizer);
+    // Run the simulation on its own thread (paced by GetPacer) while RunLoop's
+    // thread handles events and draws: each tick's rectangles go into one of
+    // three batchers handed over through a FrameMailbox, and the newest complete
+    // one is drawn and presented, so a present blocked on vsync no longer stalls
+    // the simulation. SDL wants events and the renderer on the thread that
+    // created the window, so that thread stays the render thread.
+    // Call before RunLoop; ignored with damage tracking or a rasterizer.
+    void SetRenderThread(bool enabled);
+    // Frames handed to the render thread (latency, dropped/duplicated frames)
+    FrameMailboxStats GetRenderThreadStats() const { return mFrameMailbox.GetStats(); }
+    // Pixels filled or copied by the last GenerateOutput
+    Uint64 GetPixelsTouched() const { return mPixelsTouched; }
     // Shutdown the game
     void Shutdown();
 
@@ -30,14 +102,57 @@ private:
     void ProcessInput();
     void UpdateGame();
     void GenerateOutput();
+    // RunLoop with the simulation on its own thread (see SetRenderThread)
+    void RunThreaded();
+    // Simulation thread: ticks and publishes each tick's rectangles
+    void SimulationLoop();
+    // Render thread: draws and presents the newest published frame
+    void PresentFrame();
+    // Queues the paddles and balls (and reports their bounds to mDamage)
+    void AddMovingRects(RenderBatcher& batcher);
+    // Walls and center line (never change)
+    void AddStaticRects(RenderBatcher& batcher);
+    // Renders the static scene into mBackground
+    bool CreateBackground();
+    // Advances paddles and balls by deltaTime seconds
+    void UpdateSimulation(float deltaTime);
+    // Appends this tick's input (and state hash) to the recording
+    void RecordTick();
+    // Draws frame timing bars (toggled with F1)
+    void DrawPacerOverlay(RenderBatcher& batcher);
+    // Spawns a ball at the center with a random velocity
+    BallId ServeBall();
     // Window created by SDL
     SDL_Window *mWindow;
     // draws graphics
     SDL_Renderer *mRenderer;
-    // Game should continue to run
-    bool mIsRunning;
-    Uint32 mTicksCount;
+    // collects the frame's rectangles into one draw call per color
+    RenderBatcher mBatcher;
+    // software rasterizer used instead of mRenderer (nullptr if none)
+    TiledRasterizer* mRasterizer;
+    // damage tracking: dirty rects and the static scene they're restored from
+    bool mDamageTracking;
+    DamageTracker mDamage;
+    SDL_Texture* mBackground;
+    Uint64 mPixelsTouched;
+    // render thread: frames recorded by the simulation thread, handed over by mFrameMailbox
+    bool mRenderThread;
+    RenderBatcher mRenderFrames[3];
+    FrameMailbox mFrameMailbox;
+    // Game should continue to run (either thread may end it)
+    std::atomic<bool> mIsRunning;
+    // Sleeps until the next frame is due and measures frame timing
+    FramePacer mPacer;
+    std::atomic<bool> mShowPacerOverlay;
+    // No window/renderer
+    bool mHeadless;
+    // A missed ball ends the game (windowed) instead of being served again
+    // (headless); replays follow the recorded game's rule
+    bool mEndOnMiss;
     
+    // paddle input read by ProcessInput, picked up by the next tick
+    std::atomic<int> mInputDir1;
+    std::atomic<int> mInputDir2;
     //paddles
     Vector2 mPaddlePos1;
     int mPaddleDir1;
@@ -45,6 +160,19 @@ private:
     int mPaddleDir2;
 
     //balls
-    const int numBalls = 2;
-    std::vector<Ball> balls;
+    BallStore mBalls;
+    bool mBurstMode;
+    JobSystem* mJobs;
+    // broad phase for ball-ball and ball-paddle contacts
+    bool mBallCollisions;
+    SpatialGrid mGrid;
+
+    // all randomness comes from here, so a seed reproduces a game
+    Random mRandom;
+    Uint64 mSeed;
+    int mInitialBallCount;
+    // record/replay
+    bool mRecording;
+    float mRecordDeltaTime;
+    InputLog mInputLog;
 };
\ No newline at end of file
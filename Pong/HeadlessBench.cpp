@@ -0,0 +1,98 @@
+#include "Game.h"
+#include <chrono>
+#include <ctime>
+
+// Simulated ball-ticks per ball count (keeps each run roughly the same length)
+const long long ballTicksPerRun = 100000000;
+const float fixedDeltaTime = 1.0f / 60.0f;
+// Frames run at the paced frame rate (2 seconds at 60 fps)
+const int pacedFrames = 120;
+// Burst soak: balls split on paddle hits and expire off-screen
+const int burstStartBalls = 10000;
+const int burstCapacity = 200000;
+const int burstTicks = 3000;
+
+int main(int argc, char **argv) {
+    const int ballCounts[] = {10, 10000, 1000000};
+
+    // paddle 1 sweeps up and down while paddle 2 moves the opposite way
+    std::vector<PaddleInput> script;
+    for (int i = 0; i < 60; i++) {
+        script.push_back({-1, 1});
+    }
+    for (int i = 0; i < 60; i++) {
+        script.push_back({1, -1});
+    }
+
+    printf("%10s %10s %16s %16s\n", "balls", "ticks", "ticks/s", "ns/ball/tick");
+    for (int numBalls : ballCounts) {
+        long long ticks = ballTicksPerRun / numBalls;
+        if (ticks < 100) {
+            ticks = 100;
+        }
+
+        Game game(numBalls);
+        game.InitializeHeadless();
+
+        auto start = std::chrono::steady_clock::now();
+        int simulated = game.RunHeadless(static_cast<int>(ticks), fixedDeltaTime, script);
+        auto end = std::chrono::steady_clock::now();
+        game.Shutdown();
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        double nsPerBallTick = seconds * 1e9 / (static_cast<double>(simulated) * numBalls);
+        printf("%10d %10d %16.0f %16.3f\n", numBalls, simulated, simulated / seconds, nsPerBallTick);
+    }
+
+    // Burst run: spawn/retire every tick from a fixed pool
+    {
+        Game game(burstStartBalls, burstCapacity);
+        game.InitializeHeadless();
+        game.SetBurstMode(true);
+        long long ballTicks = 0;
+        double seconds = 0.0;
+        for (int tick = 0; tick < burstTicks; tick++) {
+            ballTicks += game.GetBalls().Count();
+            auto start = std::chrono::steady_clock::now();
+            game.RunHeadless(1, fixedDeltaTime, script);
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        const BallStore& balls = game.GetBalls();
+        printf("\nburst %d ticks: %d/%d balls alive, peak %d, %d spawns rejected, %d pool allocations, %.3f ns/ball/tick\n",
+               burstTicks, balls.Count(), balls.Capacity(), balls.GetPeakCount(), balls.GetSpawnFailures(),
+               balls.GetAllocations(), seconds * 1e9 / ballTicks);
+        game.Shutdown();
+    }
+
+    // Paced run: the pacer should give nearly all of an idle frame back to the OS
+    Game game(10000);
+    game.InitializeHeadless();
+    FramePacer& pacer = game.GetPacer();
+    double workMs = 0.0, sleepMs = 0.0, spinMs = 0.0, maxOvershootMs = 0.0;
+    int dropped = 0;
+    std::clock_t cpuStart = std::clock();
+    auto wallStart = std::chrono::steady_clock::now();
+    pacer.Reset();
+    for (int frame = 0; frame < pacedFrames; frame++) {
+        float deltaTime = pacer.WaitForNextFrame();
+        game.RunHeadless(1, deltaTime, script);
+
+        const FrameStats& stats = pacer.GetStats();
+        workMs += stats.workMs;
+        sleepMs += stats.sleepMs;
+        spinMs += stats.spinMs;
+        dropped += stats.droppedFrames;
+        if (stats.overshootMs > maxOvershootMs) {
+            maxOvershootMs = stats.overshootMs;
+        }
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    double cpuSeconds = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    game.Shutdown();
+
+    printf("\npaced %d frames at %d fps (10000 balls): %.1f fps achieved, %.0f%% cpu\n",
+           pacedFrames, pacer.GetTargetFps(), pacedFrames / wallSeconds, 100.0 * cpuSeconds / wallSeconds);
+    printf("  avg work %.3f ms, avg sleep %.3f ms, avg spin %.3f ms, max overshoot %.3f ms, dropped %d\n",
+           workMs / pacedFrames, sleepMs / pacedFrames, spinMs / pacedFrames, maxOvershootMs, dropped);
+    return 0;
+}
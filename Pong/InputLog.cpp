@@ -0,0 +1,147 @@
+#include "InputLog.h"
+#include <stdio.h>
+#include <string.h>
+
+const char logMagic[8] = {'P', 'O', 'N', 'G', 'L', 'O', 'G', 1};
+// Largest ball pool a log may ask for (anything bigger is a corrupt header)
+const Uint64 maxLogBalls = 1 << 24;
+
+// Fixed-width little-endian helpers so logs move between machines
+static void WriteU64(FILE* file, Uint64 value) {
+    Uint8 bytes[8];
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = static_cast<Uint8>(value >> (8 * i));
+    }
+    fwrite(bytes, 1, 8, file);
+}
+
+static bool ReadU64(FILE* file, Uint64& value) {
+    Uint8 bytes[8];
+    if (fread(bytes, 1, 8, file) != 8) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < 8; i++) {
+        value |= static_cast<Uint64>(bytes[i]) << (8 * i);
+    }
+    return true;
+}
+
+InputLog::InputLog() {
+    mHeader = {};
+    mWithHashes = false;
+}
+
+void InputLog::Begin(const InputLogHeader& header, bool withHashes, int reserveTicks) {
+    mHeader = header;
+    mWithHashes = withHashes;
+    mInputs.clear();
+    mHashes.clear();
+    mInputs.reserve(reserveTicks);
+    if (withHashes) {
+        mHashes.reserve(reserveTicks);
+    }
+}
+
+void InputLog::Append(const PaddleInput& input, Uint64 stateHash) {
+    mInputs.push_back(static_cast<Uint8>((input.dir1 + 1) | ((input.dir2 + 1) << 2)));
+    if (mWithHashes) {
+        mHashes.push_back(stateHash);
+    }
+}
+
+PaddleInput InputLog::GetInput(int tick) const {
+    Uint8 packed = mInputs[tick];
+    return {(packed & 3) - 1, ((packed >> 2) & 3) - 1};
+}
+
+bool InputLog::Save(const char* fileName) const {
+    FILE* file = fopen(fileName, "wb");
+    if (!file) {
+        SDL_Log("Failed to open input log %s for writing", fileName);
+        return false;
+    }
+    Uint32 deltaBits;
+    memcpy(&deltaBits, &mHeader.deltaTime, sizeof(deltaBits));
+
+    fwrite(logMagic, 1, sizeof(logMagic), file);
+    WriteU64(file, mHeader.seed);
+    WriteU64(file, static_cast<Uint64>(mHeader.ballCount));
+    WriteU64(file, static_cast<Uint64>(mHeader.ballCapacity));
+    WriteU64(file, (mHeader.burstMode ? 1u : 0u) | (mHeader.ballCollisions ? 2u : 0u) | (mHeader.endOnMiss ? 4u : 0u));
+    WriteU64(file, deltaBits);
+    WriteU64(file, mInputs.size());
+    WriteU64(file, mWithHashes ? 1 : 0);
+    fwrite(mInputs.data(), 1, mInputs.size(), file);
+    for (Uint64 hash : mHashes) {
+        WriteU64(file, hash);
+    }
+
+    bool ok = ferror(file) == 0;
+    fclose(file);
+    if (!ok) {
+        SDL_Log("Failed to write input log %s", fileName);
+    }
+    return ok;
+}
+
+bool InputLog::Load(const char* fileName) {
+    FILE* file = fopen(fileName, "rb");
+    if (!file) {
+        SDL_Log("Failed to open input log %s", fileName);
+        return false;
+    }
+
+    char magic[sizeof(logMagic)];
+    Uint64 seed, ballCount, ballCapacity, modes, deltaBits, tickCount, withHashes;
+    bool ok = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+              memcmp(magic, logMagic, sizeof(magic)) == 0 &&
+              ReadU64(file, seed) && ReadU64(file, ballCount) && ReadU64(file, ballCapacity) &&
+              ReadU64(file, modes) && ReadU64(file, deltaBits) &&
+              ReadU64(file, tickCount) && ReadU64(file, withHashes);
+    if (ok) {
+        // the counts size allocations and the game's ball pool: check them
+        // against the bytes actually left and a sane pool before using them
+        long headerEnd = ftell(file);
+        fseek(file, 0, SEEK_END);
+        Uint64 remaining = static_cast<Uint64>(ftell(file) - headerEnd);
+        fseek(file, headerEnd, SEEK_SET);
+        Uint64 bytesPerTick = withHashes != 0 ? 1 + 8 : 1;
+        float deltaTime;
+        Uint32 bits = static_cast<Uint32>(deltaBits);
+        memcpy(&deltaTime, &bits, sizeof(bits));
+        if (tickCount > remaining / bytesPerTick || tickCount > 0x7fffffff || ballCount > maxLogBalls || ballCapacity > maxLogBalls ||
+            !(deltaTime > 0.0f && deltaTime <= 1.0f)) {
+            SDL_Log("Input log %s has a corrupt header (%llu ticks for %llu bytes, %llu/%llu balls, step %f)",
+                    fileName, static_cast<unsigned long long>(tickCount), static_cast<unsigned long long>(remaining),
+                    static_cast<unsigned long long>(ballCount), static_cast<unsigned long long>(ballCapacity),
+                    deltaTime);
+            fclose(file);
+            return false;
+        }
+
+        mHeader.seed = seed;
+        mHeader.ballCount = static_cast<int>(ballCount);
+        mHeader.ballCapacity = static_cast<int>(ballCapacity);
+        mHeader.burstMode = (modes & 1) != 0;
+        mHeader.ballCollisions = (modes & 2) != 0;
+        mHeader.endOnMiss = (modes & 4) != 0;
+        mHeader.deltaTime = deltaTime;
+        mWithHashes = withHashes != 0;
+
+        mInputs.resize(tickCount);
+        ok = fread(mInputs.data(), 1, tickCount, file) == tickCount;
+        mHashes.clear();
+        for (Uint64 i = 0; ok && mWithHashes && i < tickCount; i++) {
+            Uint64 hash;
+            ok = ReadU64(file, hash);
+            mHashes.push_back(hash);
+        }
+    }
+    fclose(file);
+
+    if (!ok) {
+        SDL_Log("Input log %s is truncated or not an input log", fileName);
+    }
+    return ok;
+}
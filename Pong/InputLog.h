@@ -0,0 +1,48 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Paddle directions for one simulated tick (-1 up, 0 idle, 1 down)
+struct PaddleInput {
+    int dir1;
+    int dir2;
+};
+
+// Everything needed to rebuild the starting state of a recorded game
+struct InputLogHeader {
+    Uint64 seed;
+    int ballCount;
+    int ballCapacity;
+    bool burstMode;
+    bool ballCollisions;
+    bool endOnMiss;  // the game ended when a ball went out (windowed) instead of serving it again
+    float deltaTime; // fixed simulation step every tick was run with
+};
+
+// Compact binary log of a game: the header, one byte of paddle input per tick
+// and (optionally) a hash of the simulation state after every tick.
+// File layout (little-endian): "PONGLOG" + version byte, header fields,
+// tick count, hash flag, inputs[tickCount], hashes[tickCount] (u64)
+class InputLog {
+public:
+    InputLog();
+    // Start a new log (reserves room for reserveTicks ticks up front)
+    void Begin(const InputLogHeader& header, bool withHashes, int reserveTicks);
+    void Append(const PaddleInput& input, Uint64 stateHash);
+
+    bool Save(const char* fileName) const;
+    bool Load(const char* fileName);
+
+    const InputLogHeader& GetHeader() const { return mHeader; }
+    int GetTickCount() const { return static_cast<int>(mInputs.size()); }
+    PaddleInput GetInput(int tick) const;
+    bool HasHashes() const { return mWithHashes; }
+    Uint64 GetHash(int tick) const { return mHashes[tick]; }
+
+private:
+    InputLogHeader mHeader;
+    bool mWithHashes;
+    // both directions packed into one byte: (dir1 + 1) | (dir2 + 1) << 2
+    std::vector<Uint8> mInputs;
+    std::vector<Uint64> mHashes;
+};
@@ -0,0 +1,66 @@
+#include "Game.h"
+#include <chrono>
+#include <cstring>
+
+const int benchBalls = 1000000;
+const int benchTicks = 300;
+const float fixedDeltaTime = 1.0f / 60.0f;
+
+// Runs the same seeded game on 1..maxThreads threads and checks every run
+// ends in the same state as the single-threaded one
+int main(int argc, char **argv) {
+    int maxThreads = static_cast<int>(std::thread::hardware_concurrency());
+    if (argc > 1) {
+        maxThreads = std::atoi(argv[1]);
+    }
+    if (maxThreads < 1) {
+        maxThreads = 1;
+    }
+
+    std::vector<PaddleInput> script;
+    for (int i = 0; i < 45; i++) {
+        script.push_back({-1, 1});
+    }
+    for (int i = 0; i < 45; i++) {
+        script.push_back({1, -1});
+    }
+
+    std::vector<float> referenceX, referenceVx;
+    double singleNs = 0.0;
+    printf("%d balls, %d ticks\n", benchBalls, benchTicks);
+    printf("%8s %14s %10s %10s\n", "threads", "ns/ball/tick", "speedup", "match");
+    for (int threads = 1; threads <= maxThreads; threads++) {
+        Game game(0, benchBalls);
+        // same balls for every run (and on every platform)
+        Random random(42);
+        for (int i = 0; i < benchBalls; i++) {
+            float x = static_cast<float>(random.NextInt(1000) + 12);
+            float y = static_cast<float>(random.NextInt(680) + 10);
+            float vx = static_cast<float>(random.NextInt(80) - 40) * 3.0f;
+            float vy = static_cast<float>(random.NextInt(80) - 40) * 3.0f;
+            game.SpawnBall(x, y, vx, vy);
+        }
+        game.InitializeHeadless();
+        JobSystem jobs(threads);
+        game.SetJobSystem(&jobs);
+
+        auto start = std::chrono::steady_clock::now();
+        game.RunHeadless(benchTicks, fixedDeltaTime, script);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double ns = seconds * 1e9 / (static_cast<double>(benchTicks) * benchBalls);
+
+        const BallStore& balls = game.GetBalls();
+        bool match = true;
+        if (threads == 1) {
+            singleNs = ns;
+            referenceX = balls.x;
+            referenceVx = balls.vx;
+        } else {
+            match = std::memcmp(referenceX.data(), balls.x.data(), referenceX.size() * sizeof(float)) == 0 &&
+                    std::memcmp(referenceVx.data(), balls.vx.data(), referenceVx.size() * sizeof(float)) == 0;
+        }
+        printf("%8d %14.3f %10.2f %10s\n", threads, ns, singleNs / ns, match ? "yes" : "NO");
+        game.Shutdown();
+    }
+    return 0;
+}
@@ -0,0 +1,35 @@
+#include "Random.h"
+
+// constants from the PCG reference implementation (pcg32_random_r)
+const Uint64 pcgMultiplier = 6364136223846793005ULL;
+const Uint64 pcgIncrement = 1442695040888963407ULL;
+
+Random::Random(Uint64 seed) {
+    Seed(seed);
+}
+
+void Random::Seed(Uint64 seed) {
+    mState = 0;
+    Next();
+    mState += seed;
+    Next();
+}
+
+Uint32 Random::Next() {
+    Uint64 old = mState;
+    mState = old * pcgMultiplier + pcgIncrement;
+    Uint32 xorShifted = static_cast<Uint32>(((old >> 18u) ^ old) >> 27u);
+    Uint32 rot = static_cast<Uint32>(old >> 59u);
+    return (xorShifted >> rot) | (xorShifted << ((32 - rot) & 31));
+}
+
+int Random::NextInt(int bound) {
+    // reject the top sliver so every value is equally likely
+    Uint32 range = static_cast<Uint32>(bound);
+    Uint32 threshold = (0u - range) % range;
+    Uint32 value;
+    do {
+        value = Next();
+    } while (value < threshold);
+    return static_cast<int>(value % range);
+}
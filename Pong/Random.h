@@ -0,0 +1,16 @@
+#pragma once
+#include <SDL2/SDL.h>
+
+// Small self-contained PRNG (PCG32), so a seed gives the same sequence on
+// every platform and standard library (rand() doesn't)
+class Random {
+public:
+    Random(Uint64 seed = 0);
+    void Seed(Uint64 seed);
+    Uint32 Next();
+    // Uniform integer in [0, bound)
+    int NextInt(int bound);
+
+private:
+    Uint64 mState;
+};
@@ -0,0 +1,206 @@
+#include "Game.h"
+#include <chrono>
+#include <string>
+
+// Frame time of GenerateOutput on the tiled software rasterizer (no window,
+// GPU or SDL_Renderer) across thread counts; compare with render_bench for
+// SDL's software renderer. Games use a fixed seed, so frames are reproducible:
+// --dump PREFIX writes the last frame of the 1000 ball run as PREFIX.png and
+// PREFIX.raw (golden images), --tiles prints that frame's per-tile times.
+// A second table times scaled and blended blits of a noise image across tile
+// sizes and thread counts and checks every pixel against a scalar reference.
+const int benchFrames = 120;
+const float fixedDeltaTime = 1.0f / 60.0f;
+const Uint64 benchSeed = 1;
+const int blitFrames = 20;
+const int blitCount = 4000;
+const int blitImageSize = 128;
+
+struct BenchBlit {
+    RasterRect src;
+    RasterRect dst;
+    bool blend;
+};
+
+// One channel of color over dst, rounded to nearest: (c * a + d * (255 - a)) / 255
+static uint32_t ReferenceChannel(uint32_t c, uint32_t d, uint32_t a) {
+    return ((c * a + d * (255 - a)) * 2 + 255) / 510;
+}
+
+// Draws the blits one pixel at a time, straight from the definition: each dst
+// pixel samples src at its center (16.16 fixed point) and is left alone if
+// that sample is off the image or the pixel is off the framebuffer
+static void ReferenceBlits(std::vector<uint32_t>& pixels, int width, int height, const RasterImage& image,
+                           const std::vector<BenchBlit>& blits) {
+    pixels.assign(static_cast<size_t>(width) * height, 0xFF000000);
+    for (const BenchBlit& blit : blits) {
+        int64_t stepX = (static_cast<int64_t>(blit.src.w) << 16) / blit.dst.w;
+        int64_t stepY = (static_cast<int64_t>(blit.src.h) << 16) / blit.dst.h;
+        for (int dy = 0; dy < blit.dst.h; dy++) {
+            int y = blit.dst.y + dy;
+            int sy = blit.src.y + static_cast<int>((dy * stepY + stepY / 2) >> 16);
+            if (y < 0 || y >= height || sy < 0 || sy >= image.height) {
+                continue;
+            }
+            for (int dx = 0; dx < blit.dst.w; dx++) {
+                int x = blit.dst.x + dx;
+                int sx = blit.src.x + static_cast<int>((dx * stepX + stepX / 2) >> 16);
+                if (x < 0 || x >= width || sx < 0 || sx >= image.width) {
+                    continue;
+                }
+                uint32_t color = image.pixels[sy * image.pitch + sx];
+                uint32_t& out = pixels[static_cast<size_t>(y) * width + x];
+                if (!blit.blend) {
+                    out = color;
+                    continue;
+                }
+                uint32_t a = color >> 24;
+                uint32_t result = ReferenceChannel(255, out >> 24, a) << 24;
+                for (int shift = 0; shift < 24; shift += 8) {
+                    result |= ReferenceChannel((color >> shift) & 0xFF, (out >> shift) & 0xFF, a) << shift;
+                }
+                out = result;
+            }
+        }
+    }
+}
+
+static bool RunBlitBench() {
+    const int width = 1024;
+    const int height = 700;
+    Random random(benchSeed);
+    // noise with every alpha, so blending does real work
+    std::vector<uint32_t> noise(blitImageSize * blitImageSize);
+    for (uint32_t& pixel : noise) {
+        pixel = random.Next();
+    }
+    RasterImage image = {noise.data(), blitImageSize, blitImageSize, blitImageSize};
+
+    // half blended, scaled 0.5x to 3x, some hanging off the image or the screen
+    const int scales[] = {1, 2, 3, 4, 6}; // in halves
+    std::vector<BenchBlit> blits(blitCount);
+    for (int i = 0; i < blitCount; i++) {
+        BenchBlit& blit = blits[i];
+        blit.src.w = 4 + random.NextInt(40);
+        blit.src.h = 4 + random.NextInt(40);
+        blit.src.x = random.NextInt(blitImageSize - blit.src.w + 16) - 8;
+        blit.src.y = random.NextInt(blitImageSize - blit.src.h + 16) - 8;
+        int scale = scales[random.NextInt(5)];
+        blit.dst.w = blit.src.w * scale / 2;
+        blit.dst.h = blit.src.h * scale / 2;
+        blit.dst.x = random.NextInt(width + 64) - 64;
+        blit.dst.y = random.NextInt(height + 64) - 64;
+        blit.blend = i % 2 == 1;
+    }
+
+    std::vector<uint32_t> reference;
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < blitFrames; frame++) {
+        ReferenceBlits(reference, width, height, image, blits);
+    }
+    double referenceMs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1000.0 /
+                         blitFrames;
+
+    printf("\n%d blits (%dx%d noise image, half blended, 0.5x-3x), %d frames\n", blitCount, blitImageSize,
+           blitImageSize, blitFrames);
+    printf("%10s %8s %12s %10s %12s %12s\n", "tile size", "threads", "ms/frame", "shade ms", "bin entries",
+           "mismatches");
+    printf("%10s %8d %12.3f %10s %12s %12s\n", "scalar", 1, referenceMs, "-", "-", "-");
+    const int tileSizes[] = {16, 32, 64, 128};
+    const int threadCounts[] = {1, 2, 4, 8};
+    bool ok = true;
+    for (int tileSize : tileSizes) {
+        for (int threads : threadCounts) {
+            JobSystem jobs(threads);
+            TiledRasterizer rasterizer(tileSize);
+            rasterizer.Resize(width, height);
+            rasterizer.SetJobSystem(threads > 1 ? &jobs : nullptr);
+            start = std::chrono::steady_clock::now();
+            for (int frame = 0; frame < blitFrames; frame++) {
+                rasterizer.Clear(0xFF000000);
+                for (const BenchBlit& blit : blits) {
+                    rasterizer.Blit(image, blit.src, blit.dst, blit.blend);
+                }
+                rasterizer.Execute();
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            int mismatches = 0;
+            const uint32_t* pixels = rasterizer.GetPixels();
+            for (size_t i = 0; i < reference.size(); i++) {
+                mismatches += pixels[i] != reference[i];
+            }
+            ok = ok && mismatches == 0;
+            const RasterStats& stats = rasterizer.GetStats();
+            printf("%10d %8d %12.3f %10.3f %12d %12d\n", tileSize, threads, seconds * 1000.0 / blitFrames,
+                   stats.shadeMs, stats.binEntries, mismatches);
+        }
+    }
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    const char* dumpPrefix = nullptr;
+    bool printTiles = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--dump") == 0 && i + 1 < argc) {
+            dumpPrefix = argv[++i];
+        } else if (strcmp(argv[i], "--tiles") == 0) {
+            printTiles = true;
+        }
+    }
+
+    const int ballCounts[] = {2, 1000, 100000};
+    const int threadCounts[] = {1, 2, 4, 8};
+    TiledRasterizer rasterizer;
+    rasterizer.Resize(1024, 700);
+
+    std::vector<PaddleInput> script;
+    printf("%10s %8s %12s %10s %10s %12s %12s\n", "balls", "threads", "ms/frame", "bin ms", "shade ms", "max tile ms",
+           "bin entries");
+    for (int numBalls : ballCounts) {
+        for (int threads : threadCounts) {
+            JobSystem jobs(threads);
+            rasterizer.SetJobSystem(threads > 1 ? &jobs : nullptr);
+            Game game(numBalls, 0, benchSeed);
+            game.InitializeHeadless();
+            game.SetRasterizer(&rasterizer);
+
+            auto start = std::chrono::steady_clock::now();
+            int frames = game.RunHeadless(benchFrames, fixedDeltaTime, script);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            const RasterStats& stats = rasterizer.GetStats();
+            printf("%10d %8d %12.3f %10.3f %10.3f %12.3f %12d\n", numBalls, threads, seconds * 1000.0 / frames,
+                   stats.binMs, stats.shadeMs, stats.maxTileMs, stats.binEntries);
+            game.Shutdown();
+
+            if (numBalls == 1000 && threads == 1) {
+                if (dumpPrefix) {
+                    std::string prefix = dumpPrefix;
+                    if (!rasterizer.SavePng((prefix + ".png").c_str()) ||
+                        !rasterizer.SaveRaw((prefix + ".raw").c_str())) {
+                        SDL_Log("Failed to write %s.png/.raw", dumpPrefix);
+                        return 1;
+                    }
+                }
+                if (printTiles) {
+                    const std::vector<double>& tileMs = rasterizer.GetTileMs();
+                    printf("per-tile ms (%dx%d px tiles):\n", rasterizer.GetTileSize(), rasterizer.GetTileSize());
+                    for (int ty = 0; ty < rasterizer.GetTilesY(); ty++) {
+                        for (int tx = 0; tx < rasterizer.GetTilesX(); tx++) {
+                            printf(" %6.3f", tileMs[ty * rasterizer.GetTilesX() + tx]);
+                        }
+                        printf("\n");
+                    }
+                }
+            }
+        }
+    }
+
+    if (!RunBlitBench()) {
+        SDL_Log("Tiled blits don't match the scalar reference");
+        return 1;
+    }
+    return 0;
+}
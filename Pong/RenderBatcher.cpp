@@ -0,0 +1,126 @@
+#include "RenderBatcher.h"
+#include <algorithm>
+
+RenderBatcher::RenderBatcher() {
+    mLastBatch = -1;
+    mImmediate = false;
+    mStats = {};
+}
+
+void RenderBatcher::Reserve(int rects) {
+    mRects.reserve(rects);
+    mBatchOf.reserve(rects);
+    mSorted.reserve(rects);
+}
+
+void RenderBatcher::AddRect(const SDL_Rect& rect, SDL_Color color, int layer) {
+    Uint64 key = (static_cast<Uint64>(layer) << 32) |
+                 (static_cast<Uint64>(color.r) << 24) | (color.g << 16) | (color.b << 8) | color.a;
+    mRects.push_back(rect);
+    mBatchOf.push_back(FindBatch(key, color));
+}
+
+int RenderBatcher::FindBatch(Uint64 key, SDL_Color color) {
+    // runs of the same color are the common case
+    if (mLastBatch >= 0 && mBatches[mLastBatch].key == key) {
+        return mLastBatch;
+    }
+    // a frame only has a handful of colors, a linear scan is fine
+    for (int i = 0; i < static_cast<int>(mBatches.size()); i++) {
+        if (mBatches[i].key == key) {
+            mLastBatch = i;
+            return i;
+        }
+    }
+    mBatches.push_back({key, color, 0, 0});
+    mLastBatch = static_cast<int>(mBatches.size()) - 1;
+    return mLastBatch;
+}
+
+void RenderBatcher::Flush(SDL_Renderer* renderer) {
+    int numRects = static_cast<int>(mRects.size());
+    mStats.rects = numRects;
+    mStats.drawCalls = 0;
+    mStats.colorChanges = 0;
+
+    if (mImmediate) {
+        // one state change + draw per rectangle, like the old GenerateOutput
+        for (int i = 0; i < numRects; i++) {
+            const SDL_Color& color = mBatches[mBatchOf[i]].color;
+            SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+            SDL_RenderFillRect(renderer, &mRects[i]);
+        }
+        mStats.colorChanges = numRects;
+        mStats.drawCalls = numRects;
+    } else if (numRects > 0) {
+        SortBatches();
+        for (int b : mOrder) {
+            const Batch& batch = mBatches[b];
+            const SDL_Color& color = batch.color;
+            SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+            // offset now points one past the end of the batch
+            SDL_RenderFillRects(renderer, &mSorted[batch.offset - batch.count], batch.count);
+            mStats.colorChanges++;
+            mStats.drawCalls++;
+        }
+    }
+
+    Clear();
+}
+
+void RenderBatcher::Flush(TiledRasterizer& rasterizer) {
+    int numRects = static_cast<int>(mRects.size());
+    mStats.rects = numRects;
+    mStats.drawCalls = 0;
+    mStats.colorChanges = 0;
+    if (numRects > 0) {
+        SortBatches();
+        for (int b : mOrder) {
+            const Batch& batch = mBatches[b];
+            const SDL_Color& color = batch.color;
+            Uint32 argb = (static_cast<Uint32>(color.a) << 24) | (color.r << 16) | (color.g << 8) | color.b;
+            for (int i = batch.offset - batch.count; i < batch.offset; i++) {
+                const SDL_Rect& rect = mSorted[i];
+                rasterizer.FillRect({rect.x, rect.y, rect.w, rect.h}, argb);
+            }
+            mStats.colorChanges++;
+            mStats.drawCalls++;
+        }
+    }
+    Clear();
+}
+
+void RenderBatcher::SortBatches() {
+    // batches in key order (layer first, then color)
+    int numRects = static_cast<int>(mRects.size());
+    int numBatches = static_cast<int>(mBatches.size());
+    mOrder.resize(numBatches);
+    for (int i = 0; i < numBatches; i++) {
+        mOrder[i] = i;
+    }
+    std::sort(mOrder.begin(), mOrder.end(), [this](int a, int b) {
+        return mBatches[a].key < mBatches[b].key;
+    });
+
+    // counting sort: count per batch, prefix sum into offsets, then scatter
+    // (each offset ends up one past the end of its batch)
+    for (int i = 0; i < numRects; i++) {
+        mBatches[mBatchOf[i]].count++;
+    }
+    int offset = 0;
+    for (int b : mOrder) {
+        mBatches[b].offset = offset;
+        offset += mBatches[b].count;
+    }
+    mSorted.resize(numRects);
+    for (int i = 0; i < numRects; i++) {
+        mSorted[mBatches[mBatchOf[i]].offset++] = mRects[i];
+    }
+}
+
+void RenderBatcher::Clear() {
+    mRects.clear();
+    mBatchOf.clear();
+    mBatches.clear();
+    mLastBatch = -1;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "../Common/TiledRasterizer.h"
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Draw counts for the last flushed frame
+struct RenderBatchStats {
+    int rects;        // rectangles submitted
+    int drawCalls;    // SDL_RenderFillRect(s) calls issued
+    int colorChanges; // SDL_SetRenderDrawColor calls issued
+};
+
+// Collects every filled rectangle of a frame and submits them with one
+// SDL_RenderFillRects call per (layer, color). Rectangles on a higher layer are
+// drawn after lower layers; within a layer, rectangles of one color keep the
+// order they were added in.
+// Rectangle and batch arrays are cleared rather than freed, so a frame with no
+// more rectangles or colors than an earlier one doesn't allocate.
+class RenderBatcher {
+public:
+    RenderBatcher();
+    // Pre-size the buffers for a frame of this many rectangles
+    void Reserve(int rects);
+    // Immediate mode issues one SDL_RenderFillRect per rectangle in submission
+    // order (the unbatched baseline)
+    void SetImmediate(bool immediate) { mImmediate = immediate; }
+    bool IsImmediate() const { return mImmediate; }
+
+    void AddRect(const SDL_Rect& rect, SDL_Color color, int layer = 0);
+    // Rectangles added since the last flush or clear
+    int GetRectCount() const { return static_cast<int>(mRects.size()); }
+    // Forgets the rectangles added so far (keeping the capacity); Flush does
+    // this after drawing, a buffer that is reused without a flush needs it
+    void Clear();
+    // Draws everything added since the last flush
+    void Flush(SDL_Renderer* renderer);
+    // Same order as the batched path, recorded into a software rasterizer
+    // (one FillRect per rectangle; drawCalls counts the batches)
+    void Flush(TiledRasterizer& rasterizer);
+    const RenderBatchStats& GetStats() const { return mStats; }
+
+private:
+    // One distinct (layer, color) state seen this frame
+    struct Batch {
+        Uint64 key; // layer in the high bits, then RGBA
+        SDL_Color color;
+        int count;
+        int offset; // start of this batch in mSorted
+    };
+    int FindBatch(Uint64 key, SDL_Color color);
+    // Orders the batches by key and groups the rectangles into mSorted
+    void SortBatches();
+
+    // rectangles in submission order and the batch each one belongs to
+    std::vector<SDL_Rect> mRects;
+    std::vector<int> mBatchOf;
+    // rectangles grouped by batch (one contiguous range per batch)
+    std::vector<SDL_Rect> mSorted;
+    std::vector<Batch> mBatches;
+    // batch indices ordered by key
+    std::vector<int> mOrder;
+    int mLastBatch;
+    bool mImmediate;
+    RenderBatchStats mStats;
+};
@@ -0,0 +1,87 @@
+#include "Game.h"
+#include <chrono>
+
+// Frame time of GenerateOutput on SDL's software renderer (no window/GPU needed):
+// immediate and batched full redraws, and batched with damage tracking.
+// First checks the render thread's frame hand-over (see CheckSkippedFrames).
+const int benchFrames = 120;
+const float fixedDeltaTime = 1.0f / 60.0f;
+
+// Publishes frames the way Game's simulation thread does, with nobody picking
+// them up: dropped buffers come back to the producer unflushed, and none of
+// their rectangles may leak into the next frame
+static bool CheckSkippedFrames() {
+    const int frames = 5;
+    const int rectsPerFrame = 10;
+    RenderBatcher buffers[3];
+    FrameMailbox mailbox;
+    for (int f = 0; f < frames; f++) {
+        RenderBatcher& frame = buffers[mailbox.GetWriteIndex()];
+        frame.Clear();
+        for (int i = 0; i < rectsPerFrame; i++) {
+            frame.AddRect({i * 20, f * 20, 10, 10}, {255, 255, 255, 255});
+        }
+        mailbox.Publish();
+    }
+    int index = mailbox.Acquire(0.0);
+    FrameMailboxStats stats = mailbox.GetStats();
+    if (index < 0 || buffers[index].GetRectCount() != rectsPerFrame || stats.dropped != frames - 1) {
+        SDL_Log("Skipped frames check failed: %d rects in the newest frame (expected %d), %llu dropped (expected %d)",
+                index < 0 ? 0 : buffers[index].GetRectCount(), rectsPerFrame,
+                static_cast<unsigned long long>(stats.dropped), frames - 1);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (!CheckSkippedFrames()) {
+        return 1;
+    }
+    const int ballCounts[] = {2, 100, 1000, 10000, 100000};
+    const char* modes[] = {"immediate", "batched", "damage"};
+
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, 1024, 700, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!target) {
+        SDL_Log("Failed to create surface: %s", SDL_GetError());
+        return 1;
+    }
+    SDL_Renderer* renderer = SDL_CreateSoftwareRenderer(target);
+    if (!renderer) {
+        SDL_Log("Failed to create software renderer: %s", SDL_GetError());
+        return 1;
+    }
+
+    std::vector<PaddleInput> script;
+    printf("%10s %10s %12s %12s %12s %14s %12s\n", "balls", "mode", "ms/frame", "draw calls", "rects", "pixels/frame",
+           "dirty rects");
+    for (int numBalls : ballCounts) {
+        for (int mode = 0; mode < 3; mode++) {
+            Game game(numBalls);
+            game.InitializeHeadless(renderer);
+            game.GetBatcher().SetImmediate(mode == 0);
+            game.SetDamageTracking(mode == 2);
+
+            auto start = std::chrono::steady_clock::now();
+            int frames = game.RunHeadless(benchFrames, fixedDeltaTime, script);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            const RenderBatchStats& stats = game.GetBatcher().GetStats();
+            // dirty rects of the last frame ("full" when it repainted everything)
+            const DamageTracker& damage = game.GetDamage();
+            char dirty[16] = "-";
+            if (mode == 2 && damage.IsFull()) {
+                snprintf(dirty, sizeof(dirty), "full");
+            } else if (mode == 2) {
+                snprintf(dirty, sizeof(dirty), "%d", static_cast<int>(damage.GetDirtyRects().size()));
+            }
+            printf("%10d %10s %12.3f %12d %12d %14llu %12s\n", numBalls, modes[mode], seconds * 1000.0 / frames,
+                   stats.drawCalls, stats.rects, static_cast<unsigned long long>(game.GetPixelsTouched()), dirty);
+            game.Shutdown();
+        }
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    return 0;
+}
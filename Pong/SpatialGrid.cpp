@@ -0,0 +1,172 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid() {
+    mInvCellSize = 1.0f;
+    mCols = 0;
+    mRows = 0;
+}
+
+void SpatialGrid::Configure(float width, float height, float cellSize, int maxItems) {
+    mInvCellSize = 1.0f / cellSize;
+    mCols = static_cast<int>(std::ceil(width / cellSize));
+    mRows = static_cast<int>(std::ceil(height / cellSize));
+    mCellStart.assign(mCols * mRows + 1, 0);
+    mCursor.assign(mCols * mRows, 0);
+    mItems.assign(maxItems, 0);
+    mCellOfItem.assign(maxItems, 0);
+}
+
+int SpatialGrid::CellAt(float x, float y) const {
+    // balls leaving the field are kept in the border cells
+    int cx = static_cast<int>(x * mInvCellSize);
+    int cy = static_cast<int>(y * mInvCellSize);
+    cx = cx < 0 ? 0 : (cx >= mCols ? mCols - 1 : cx);
+    cy = cy < 0 ? 0 : (cy >= mRows ? mRows - 1 : cy);
+    return cy * mCols + cx;
+}
+
+void SpatialGrid::Build(const BallStore& balls) {
+    int count = balls.Count();
+    int numCells = mCols * mRows;
+
+    // count balls per cell (shifted by one so the prefix sum gives start offsets)
+    std::fill(mCellStart.begin(), mCellStart.end(), 0);
+    for (int i = 0; i < count; i++) {
+        int cell = CellAt(balls.x[i], balls.y[i]);
+        mCellOfItem[i] = cell;
+        mCellStart[cell + 1]++;
+    }
+    for (int c = 0; c < numCells; c++) {
+        mCellStart[c + 1] += mCellStart[c];
+    }
+    // scatter ball indices (ascending within each cell)
+    std::copy(mCellStart.begin(), mCellStart.end() - 1, mCursor.begin());
+    for (int i = 0; i < count; i++) {
+        mItems[mCursor[mCellOfItem[i]]++] = i;
+    }
+}
+
+// Tests (and optionally resolves) one pair; returns true if they overlap
+static bool CollidePair(BallStore& balls, int a, int b, float minDist, bool resolve) {
+    float dx = balls.x[b] - balls.x[a];
+    float dy = balls.y[b] - balls.y[a];
+    float dist2 = dx * dx + dy * dy;
+    if (dist2 >= minDist * minDist) {
+        return false;
+    }
+    if (!resolve || dist2 == 0.0f) { // no normal for coincident centers
+        return true;
+    }
+
+    float dist = std::sqrt(dist2);
+    float nx = dx / dist;
+    float ny = dy / dist;
+    // exchange the velocity components along the normal if approaching
+    float approach = (balls.vx[b] - balls.vx[a]) * nx + (balls.vy[b] - balls.vy[a]) * ny;
+    if (approach < 0.0f) {
+        balls.vx[a] += approach * nx;
+        balls.vy[a] += approach * ny;
+        balls.vx[b] -= approach * nx;
+        balls.vy[b] -= approach * ny;
+    }
+    // push apart so they don't stay stuck together
+    float push = (minDist - dist) * 0.5f;
+    balls.x[a] -= push * nx;
+    balls.y[a] -= push * ny;
+    balls.x[b] += push * nx;
+    balls.y[b] += push * ny;
+    return true;
+}
+
+int CollideBalls(BallStore& balls, const SpatialGrid& grid, float ballRadius, bool resolve) {
+    const float minDist = 2.0f * ballRadius;
+    const int* items = grid.Items();
+    const int cols = grid.GetCols();
+    const int rows = grid.GetRows();
+    // half of the neighborhood, so each pair of cells is visited once
+    const int neighborX[] = {1, -1, 0, 1};
+    const int neighborY[] = {0, 1, 1, 1};
+    int contacts = 0;
+
+    for (int cy = 0; cy < rows; cy++) {
+        for (int cx = 0; cx < cols; cx++) {
+            int cell = cy * cols + cx;
+            int begin = grid.CellStart(cell);
+            int end = grid.CellStart(cell + 1);
+            for (int i = begin; i < end; i++) {
+                int a = items[i];
+                // rest of this cell
+                for (int j = i + 1; j < end; j++) {
+                    contacts += CollidePair(balls, a, items[j], minDist, resolve);
+                }
+                // forward neighbors
+                for (int n = 0; n < 4; n++) {
+                    int nx = cx + neighborX[n];
+                    int ny = cy + neighborY[n];
+                    if (nx < 0 || nx >= cols || ny >= rows) {
+                        continue;
+                    }
+                    int other = ny * cols + nx;
+                    int otherEnd = grid.CellStart(other + 1);
+                    for (int j = grid.CellStart(other); j < otherEnd; j++) {
+                        contacts += CollidePair(balls, a, items[j], minDist, resolve);
+                    }
+                }
+            }
+        }
+    }
+    return contacts;
+}
+
+int CollideBallsBruteForce(BallStore& balls, float ballRadius, bool resolve) {
+    const float minDist = 2.0f * ballRadius;
+    int count = balls.Count();
+    int contacts = 0;
+    for (int a = 0; a < count; a++) {
+        for (int b = a + 1; b < count; b++) {
+            contacts += CollidePair(balls, a, b, minDist, resolve);
+        }
+    }
+    return contacts;
+}
+
+int CollidePaddle(BallStore& balls, const SpatialGrid& grid, float ballHalf,
+                  float paddleX, float paddleY, float paddleHalfW, float paddleHalfH) {
+    // cells a touching ball's center can be in
+    float left = paddleX - paddleHalfW - ballHalf;
+    float right = paddleX + paddleHalfW + ballHalf;
+    float top = paddleY - paddleHalfH - ballHalf;
+    float bottom = paddleY + paddleHalfH + ballHalf;
+    int firstCell = grid.CellAt(left, top);
+    int lastCell = grid.CellAt(right, bottom);
+    int cols = grid.GetCols();
+    const int* items = grid.Items();
+    int hits = 0;
+
+    for (int cy = firstCell / cols; cy <= lastCell / cols; cy++) {
+        for (int cx = firstCell % cols; cx <= lastCell % cols; cx++) {
+            int cell = cy * cols + cx;
+            int end = grid.CellStart(cell + 1);
+            for (int i = grid.CellStart(cell); i < end; i++) {
+                int b = items[i];
+                float x = balls.x[b];
+                float y = balls.y[b];
+                if (x <= left || x >= right || y <= top || y >= bottom) {
+                    continue;
+                }
+                // only bounce balls heading into the paddle
+                float side = x < paddleX ? -1.0f : 1.0f;
+                if (balls.vx[b] * side >= 0.0f) {
+                    continue;
+                }
+                balls.vx[b] = -balls.vx[b];
+                balls.x[b] = paddleX + side * (paddleHalfW + ballHalf);
+                balls.flags[b] |= kBallHitPaddle;
+                hits++;
+            }
+        }
+    }
+    return hits;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "BallStore.h"
+#include <vector>
+
+// Uniform grid broad phase, rebuilt from scratch every tick.
+// Balls are counting-sorted by cell into one flat index array, so a cell is
+// just a range [CellStart(c), CellStart(c + 1)) of Items() (no per-cell containers).
+class SpatialGrid {
+public:
+    SpatialGrid();
+    // Allocate for a width x height field and up to maxItems balls
+    // (cellSize should be at least the ball diameter)
+    void Configure(float width, float height, float cellSize, int maxItems);
+    // Bucket the first count balls by the cell their center is in
+    void Build(const BallStore& balls);
+
+    int GetCols() const { return mCols; }
+    int GetRows() const { return mRows; }
+    int CellAt(float x, float y) const;
+    int CellStart(int cell) const { return mCellStart[cell]; }
+    const int* Items() const { return mItems.data(); }
+
+private:
+    float mInvCellSize;
+    int mCols;
+    int mRows;
+    // numCells + 1 offsets into mItems
+    std::vector<int> mCellStart;
+    // ball indices sorted by cell
+    std::vector<int> mItems;
+    // scratch for the counting sort
+    std::vector<int> mCellOfItem;
+    std::vector<int> mCursor;
+};
+
+// Ball-ball narrow phase over the grid. Balls are treated as circles of
+// ballRadius; touching pairs that are approaching swap their velocity along
+// the contact normal (equal masses) and are pushed apart. Pairs are visited in
+// a fixed cell order, so results are deterministic.
+// Returns the number of overlapping pairs (resolve = false only counts them).
+int CollideBalls(BallStore& balls, const SpatialGrid& grid, float ballRadius, bool resolve);
+// Reference O(n^2) version (same pair test, different visiting order)
+int CollideBallsBruteForce(BallStore& balls, float ballRadius, bool resolve);
+
+// Ball-paddle narrow phase using the grid cells under the paddle rectangle.
+// A ball overlapping the paddle and moving towards it is reflected on x, moved
+// out to the paddle face and flagged kBallHitPaddle. Returns the number of hits.
+int CollidePaddle(BallStore& balls, const SpatialGrid& grid, float ballHalf,
+                  float paddleX, float paddleY, float paddleHalfW, float paddleHalfH);
@@ -1,13 +1,100 @@
 #include "Game.h"
+#include <chrono>
+#include <cstring>
 #include <iostream>
 
+// Fixed step used while recording
+const float recordDeltaTime = 1.0f / 60.0f;
+
+// Replays a recorded game headless at full speed and checks it against the log
+int Replay(const char* fileName, int threads) {
+    InputLog log;
+    if (!log.Load(fileName)) {
+        return 1;
+    }
+    const InputLogHeader& header = log.GetHeader();
+    Game game(header.ballCount, header.ballCapacity, header.seed);
+    game.InitializeHeadless();
+    JobSystem jobs(threads);
+    game.SetJobSystem(&jobs);
+
+    auto start = std::chrono::steady_clock::now();
+    int divergedAt = game.RunReplay(log);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    game.Shutdown();
+
+    printf("replayed %d ticks in %.3f s (%.0f ticks/s)\n", log.GetTickCount(), seconds, log.GetTickCount() / seconds);
+    if (!log.HasHashes()) {
+        printf("log has no state hashes, nothing to compare\n");
+    } else if (divergedAt >= 0) {
+        printf("DIVERGED at tick %d\n", divergedAt);
+        return 2;
+    } else {
+        printf("state matches the recording on every tick\n");
+    }
+    return 0;
+}
+
 int main(int argc, char **argv) {
-    Game game;
+    // optional: --balls N, --burst (balls split on paddle hits and expire off-screen),
+    // --threads N (ball update threads, 0 = one per core), --collide (ball-ball collisions),
+    // --seed N, --record FILE (save input log on exit), --replay FILE (headless, no window),
+    // --damage (software rendering, repaint only what moved),
+    // --render-thread (simulate on a second thread while this one draws and presents)
+    int ballCount = 2;
+    bool burst = false;
+    bool collide = false;
+    bool damage = false;
+    bool renderThread = false;
+    int threads = 0;
+    Uint64 seed = 0;
+    const char* recordFile = nullptr;
+    const char* replayFile = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--balls") == 0 && i + 1 < argc) {
+            ballCount = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--burst") == 0) {
+            burst = true;
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--collide") == 0) {
+            collide = true;
+        } else if (std::strcmp(argv[i], "--damage") == 0) {
+            damage = true;
+        } else if (std::strcmp(argv[i], "--render-thread") == 0) {
+            renderThread = true;
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordFile = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayFile = argv[++i];
+        }
+    }
+
+    if (replayFile) {
+        return Replay(replayFile, threads);
+    }
+
+    // burst mode grows the ball count, so leave room in the pool
+    Game game(ballCount, burst ? ballCount * 64 : ballCount, seed);
+    game.SetBurstMode(burst);
+    game.SetBallCollisions(collide);
+    game.SetDamageTracking(damage);
+    game.SetRenderThread(renderThread);
+    JobSystem jobs(threads);
+    game.SetJobSystem(&jobs);
+    if (recordFile) {
+        game.StartRecording(recordDeltaTime);
+    }
 
     bool success = game.Initialize();
     if (success) {
         game.RunLoop();
     }
+    if (recordFile) {
+        game.SaveRecording(recordFile);
+    }
     game.Shutdown();
     return 0;
-}
\ No newline at end of file
+}
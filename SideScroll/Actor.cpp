@@ -1 +1,92 @@
-#include "Actor.h"
\ No newline at end of file
+#include "Actor.h"
+#include "../Common/Profiler.h"
+#include "Component.h"
+#include "Game.h"
+#include <algorithm>
+
+Actor::Actor(Game* game) {
+    mState = EActive;
+    mListIndex = -1;
+    mPending = false;
+    mGame = game;
+    mTransformSlot = mGame->GetTransforms().Create();
+    mTransform = mGame->GetTransforms().GetChunk(mTransformSlot);
+    mTransformIndex = mTransformSlot % TransformChunk::kSize;
+    mGame->AddActor(this);
+}
+
+Actor::~Actor() {
+    mGame->RemoveActor(this);
+    // Need to delete components
+    // (each component removes itself from mComponents in its destructor)
+    while (!mComponents.empty()) {
+        mComponents.back()->Destroy();
+    }
+    while (!mPooledComponents.empty()) {
+        mPooledComponents.back()->Destroy();
+    }
+    mGame->GetTransforms().Destroy(mTransformSlot);
+}
+
+void Actor::Update(float deltaTime) {
+    // only active actors update
+    if (mState == EActive) {
+        PROFILE_SCOPE("Actor::Update");
+        UpdateComponents(deltaTime);
+        UpdateActor(deltaTime);
+    }
+}
+
+void Actor::UpdateComponents(float deltaTime) {
+    for (auto comp : mComponents) {
+        PROFILE_SCOPE("Component::Update");
+        comp->Update(deltaTime);
+    }
+}
+
+void Actor::UpdateActor(float deltaTime) {
+}
+
+void Actor::SetState(State state) {
+    mState = state;
+    // pooled components are updated without looking at their actor
+    for (auto comp : mPooledComponents) {
+        comp->OnOwnerStateChanged(state == EActive);
+    }
+}
+
+bool Actor::SetParent(Actor* parent) {
+    return mGame->GetTransforms().SetParent(mTransformSlot, parent ? parent->mTransformSlot : -1);
+}
+
+void Actor::AddComponent(Component* component) {
+    // Find the insertion point in the sorted vector
+    // (The first element with a higher update order than me)
+    int myOrder = component->GetUpdateOrder();
+    auto iter = mComponents.begin();
+    for (; iter != mComponents.end(); ++iter) {
+        if (myOrder < (*iter)->GetUpdateOrder()) {
+            break;
+        }
+    }
+    // Inserts element before position of iterator
+    mComponents.insert(iter, component);
+}
+
+void Actor::RemoveComponent(Component* component) {
+    auto iter = std::find(mComponents.begin(), mComponents.end(), component);
+    if (iter != mComponents.end()) {
+        mComponents.erase(iter);
+        return;
+    }
+    iter = std::find(mPooledComponents.begin(), mPooledComponents.end(), component);
+    if (iter != mPooledComponents.end()) {
+        mPooledComponents.erase(iter);
+    }
+}
+
+void Actor::OnComponentPooled(Component* component) {
+    // the constructor just added it to mComponents
+    RemoveComponent(component);
+    mPooledComponents.emplace_back(component);
+}
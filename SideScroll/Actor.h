@@ -1,8 +1,17 @@
+#pragma once
+#include "../Common/Arena.h"
+#include "../Common/Math.h"
+#include "TransformSystem.h"
+#include <stddef.h>
 #include <vector>
 
-struct Vector2 {
-    float x;
-    float y;
+// Weak reference to an actor: slot index into Game's actor table plus the
+// generation the slot had when the handle was made. Once the actor is deleted
+// the slot's generation moves on and Game::GetActor returns nullptr.
+struct ActorHandle {
+    int index = -1;
+    unsigned int generation = 0;
+    bool operator==(const ActorHandle& other) const { return index == other.index && generation == other.generation; }
 };
 
 class Actor {
@@ -16,6 +25,9 @@ public:
     // Constructor/destructor
     Actor(class Game* game);
     virtual ~Actor();
+    // Actors live in the level pool (Game::UnloadData releases it in one shot)
+    static void* operator new(size_t size) { return GetLevelPool().Allocate(size); }
+    static void operator delete(void* ptr, size_t size) { GetLevelPool().Free(ptr, size); }
     // Update function called from Game (not overridable)
     void Update(float deltaTime);
     // Updates all the components attached to the actor (not overridable)
@@ -24,20 +36,74 @@ public:
     virtual void UpdateActor(float deltaTime);
 
     // Getters/setters
-    State GetState();
+    State GetState() const { return mState; }
+    void SetState(State state);
+    ActorHandle GetHandle() const { return mHandle; }
+    // Local transform (relative to the parent actor, if any); setting it marks
+    // the world transform for recomputation by the game's TransformSystem
+    const Vector2& GetPosition() const { return mTransform->position[mTransformIndex]; }
+    void SetPosition(const Vector2& position) {
+        mTransform->position[mTransformIndex] = position;
+        mTransform->dirty[mTransformIndex] = 1;
+    }
+    float GetScale() const { return mTransform->scale[mTransformIndex]; }
+    void SetScale(float scale) {
+        mTransform->scale[mTransformIndex] = scale;
+        mTransform->dirty[mTransformIndex] = 1;
+    }
+    float GetRotation() const { return mTransform->rotation[mTransformIndex]; }
+    void SetRotation(float rotation) {
+        mTransform->rotation[mTransformIndex] = rotation;
+        mTransform->dirty[mTransformIndex] = 1;
+    }
+    // World transform as of the last TransformSystem::Update (once per frame,
+    // after the actors update)
+    Vector2 GetWorldPosition() const { return {mTransform->worldX[mTransformIndex], mTransform->worldY[mTransformIndex]}; }
+    float GetWorldScale() const { return mTransform->worldScale[mTransformIndex]; }
+    float GetWorldRotation() const { return mTransform->worldRotation[mTransformIndex]; }
+    float GetWorldCosine() const { return mTransform->worldCosine[mTransformIndex]; }
+    float GetWorldSine() const { return mTransform->worldSine[mTransformIndex]; }
+    Matrix2D GetWorldTransform() const {
+        return Matrix2D::FromCosSin(GetWorldPosition(), GetWorldCosine(), GetWorldSine(), GetWorldScale());
+    }
+    // The actor's transform becomes relative to the parent's (nullptr detaches;
+    // fails if the parent is a descendant)
+    bool SetParent(Actor* parent);
+    class Game* GetGame() { return mGame; }
+
+    // Bookkeeping owned by Game: handle slot and position in mActors
+    // (listIndex is -1 once Game has already taken the actor out of mActors, or
+    // while it's pending: created during the update and not added yet)
+    void SetHandle(ActorHandle handle) { mHandle = handle; }
+    int GetListIndex() const { return mListIndex; }
+    bool IsPending() const { return mPending; }
+    void SetListIndex(int listIndex, bool pending) {
+        mListIndex = listIndex;
+        mPending = pending;
+    }
 
     // Add/remove components
     void AddComponent(class Component* component);
     void RemoveComponent(class Component* component);
+    // Called once a component was placed in a ComponentPool
+    // (it is then updated by the ComponentStore, not by UpdateComponents)
+    void OnComponentPooled(class Component* component);
 
 private:
     // Actor's state
     State mState;
-    // Transform
-    Vector2 mPosition; // Center position of actor
-    float mScale;      // Uniforms scale of actor (1.0f for 100%)
-    float mRotation;   // Rotation angle (in radians)
-    // Components held by this actor
-    std::vector<class Component*> mComponents;
+    // Transform: center position, uniform scale (1.0f for 100%) and rotation
+    // (in radians), kept in the game's TransformSystem
+    TransformChunk* mTransform;
+    int mTransformIndex;
+    int mTransformSlot;
+    // Components held by this actor (sorted by update order)
+    std::vector<class Component*, LevelAllocator<class Component*>> mComponents;
+    // Components living in a ComponentPool
+    std::vector<class Component*, LevelAllocator<class Component*>> mPooledComponents;
     class Game* mGame;
+    // Where Game keeps this actor
+    ActorHandle mHandle;
+    int mListIndex;
+    bool mPending;
 };
\ No newline at end of file
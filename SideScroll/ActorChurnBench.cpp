@@ -0,0 +1,144 @@
+#include "../Common/AllocCounter.h"
+#include "BenchUtil.h"
+#include "Game.h"
+#include <algorithm>
+
+// Spawns and kills 10k short-lived actors per frame on top of 20k long-lived
+// ones. Compares Game (handle slots, swap-and-pop, one compaction pass) with
+// the previous find/erase bookkeeping, replayed here on plain objects, and
+// counts the heap allocations Game makes once it has warmed up.
+const int spawnPerFrame = 10000;
+const int persistentActors = 20000;
+const int projectileFrames = 3;
+const int benchFrames = 200;
+const float fixedDeltaTime = 1.0f / 60.0f;
+
+class Projectile : public Actor {
+public:
+    Projectile(Game* game) : Actor(game), mFramesLeft(projectileFrames) {
+        new Component(this);
+    }
+    void UpdateActor(float deltaTime) override {
+        if (--mFramesLeft == 0) {
+            SetState(EDead);
+        }
+    }
+
+private:
+    int mFramesLeft;
+};
+
+// Spawns the projectiles while actors are updating (so they go through pending)
+class Spawner : public Actor {
+public:
+    Spawner(Game* game) : Actor(game), mGame(game) {}
+    void UpdateActor(float deltaTime) override {
+        for (int i = 0; i < spawnPerFrame; i++) {
+            new Projectile(mGame);
+        }
+    }
+
+private:
+    Game* mGame;
+};
+
+// The old Game::AddActor/RemoveActor/UpdateGame actor bookkeeping
+struct LegacyActor {
+    int framesLeft;
+    bool dead;
+};
+
+class LegacyWorld {
+public:
+    ~LegacyWorld() {
+        for (auto actor : mActors) {
+            delete actor;
+        }
+    }
+    void Add(LegacyActor* actor) {
+        if (mUpdatingActors) {
+            mPendingActors.emplace_back(actor);
+        } else {
+            mActors.emplace_back(actor);
+        }
+    }
+    void Remove(LegacyActor* actor) {
+        auto pos = std::find(mActors.begin(), mActors.end(), actor);
+        if (pos != mActors.end()) {
+            mActors.erase(pos);
+        } else {
+            pos = std::find(mPendingActors.begin(), mPendingActors.end(), actor);
+            mPendingActors.erase(pos);
+        }
+    }
+    void Update() {
+        mUpdatingActors = true;
+        for (auto actor : mActors) {
+            if (actor->framesLeft < 0) {
+                // the spawner
+                for (int i = 0; i < spawnPerFrame; i++) {
+                    Add(new LegacyActor{projectileFrames, false});
+                }
+            } else if (actor->framesLeft > 0 && --actor->framesLeft == 0) {
+                actor->dead = true;
+            }
+        }
+        mUpdatingActors = false;
+        for (auto pending : mPendingActors) {
+            mActors.emplace_back(pending);
+        }
+        mPendingActors.clear();
+        std::vector<LegacyActor*> deadActors;
+        for (auto actor : mActors) {
+            if (actor->dead) {
+                deadActors.emplace_back(actor);
+            }
+        }
+        for (auto actor : deadActors) {
+            Remove(actor);
+            delete actor;
+        }
+    }
+
+    std::vector<LegacyActor*> mActors;
+    std::vector<LegacyActor*> mPendingActors;
+    bool mUpdatingActors = false;
+};
+
+int main(int argc, char** argv) {
+    LegacyWorld legacy;
+    // framesLeft 0 never dies, -1 marks the spawner
+    for (int i = 0; i < persistentActors; i++) {
+        legacy.Add(new LegacyActor{0, false});
+    }
+    legacy.Add(new LegacyActor{-1, false});
+    double legacyMs = MsPerFrame(benchFrames, [&](int) { legacy.Update(); });
+
+    Game* game = new Game();
+    for (int i = 0; i < persistentActors; i++) {
+        new Actor(game);
+    }
+    Spawner* spawner = new Spawner(game);
+    // let the arenas and actor vectors reach their high-water mark
+    for (int frame = 0; frame < 10; frame++) {
+        game->UpdateActors(fixedDeltaTime);
+    }
+    uint64_t allocationsBefore = AllocCounter::GetCount();
+    double gameMs = MsPerFrame(benchFrames, [&](int) { game->UpdateActors(fixedDeltaTime); });
+    double allocationsPerFrame = static_cast<double>(AllocCounter::GetCount() - allocationsBefore) / benchFrames;
+
+    // handles to reaped actors must come back as nullptr
+    ActorHandle spawnerHandle = spawner->GetHandle();
+    bool handlesOk = game->GetActor(spawnerHandle) == spawner;
+    spawner->SetState(Actor::EDead);
+    game->UpdateActors(fixedDeltaTime);
+    handlesOk = handlesOk && game->GetActor(spawnerHandle) == nullptr;
+
+    printf("%d persistent actors, %d spawned/killed per frame, %d frames\n", persistentActors, spawnPerFrame,
+           benchFrames);
+    printf("%-22s %10.3f ms/frame (%zu actors)\n", "find + erase", legacyMs, legacy.mActors.size());
+    printf("%-22s %10.3f ms/frame (%.2fx), %.1f heap allocations/frame\n", "handles + compaction", gameMs,
+           legacyMs / gameMs, allocationsPerFrame);
+    printf("stale handles %s\n", handlesOk ? "ok" : "MISMATCH");
+    return handlesOk ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+#include "BenchUtil.h"
+#include "Game.h"
+#include <stdio.h>
+
+// Animates 100k sprites at 8-12 fps: a flipbook component per sprite (virtual
+// Update, SetTexture with one texture per frame every update) vs. the
+// AnimationSystem advancing every clock in one loop over frame tables.
+const int benchSprites = 100000;
+const int benchFrames = 200;
+const int clipFrames = 8;
+const int frameSize = 32;
+const float fixedDeltaTime = 1.0f / 60.0f;
+
+// The per-actor way: keeps its own clock and swaps textures each update
+class FlipbookComponent : public SpriteComponent {
+public:
+    FlipbookComponent(Actor* owner, SDL_Texture** frames, float framesPerSecond)
+        : SpriteComponent(owner), mFrames(frames), mFramesPerSecond(framesPerSecond), mCurrentFrame(0.0f) {
+        SetTexture(mFrames[0]);
+    }
+    void Update(float deltaTime) override {
+        mCurrentFrame += mFramesPerSecond * deltaTime;
+        while (mCurrentFrame >= clipFrames) {
+            mCurrentFrame -= clipFrames;
+        }
+        SetTexture(mFrames[static_cast<int>(mCurrentFrame)]);
+    }
+
+private:
+    SDL_Texture** mFrames;
+    float mFramesPerSecond;
+    float mCurrentFrame;
+};
+
+int main(int argc, char** argv) {
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    if (!renderer) {
+        SDL_Log("Failed to create software renderer: %s", SDL_GetError());
+        return 1;
+    }
+
+    // the same clip as separate textures and as one sheet
+    SDL_Texture* frameTextures[clipFrames];
+    SDL_Surface* frameSurface = SDL_CreateRGBSurfaceWithFormat(0, frameSize, frameSize, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Surface* sheetSurface =
+        SDL_CreateRGBSurfaceWithFormat(0, frameSize * clipFrames, frameSize, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!frameSurface || !sheetSurface) {
+        SDL_Log("Failed to create surface: %s", SDL_GetError());
+        return 1;
+    }
+    for (int i = 0; i < clipFrames; i++) {
+        frameTextures[i] = SDL_CreateTextureFromSurface(renderer, frameSurface);
+    }
+    SDL_Texture* sheet = SDL_CreateTextureFromSurface(renderer, sheetSurface);
+    SDL_FreeSurface(frameSurface);
+    SDL_FreeSurface(sheetSurface);
+
+    // actors are left to process exit, tearing down 100k actors isn't what's measured
+    Game* componentGame = new Game();
+    for (int i = 0; i < benchSprites; i++) {
+        Actor* actor = new Actor(componentGame);
+        new FlipbookComponent(actor, frameTextures, 8.0f + i % 5);
+    }
+
+    Game* systemGame = new Game();
+    AnimationSystem& animations = systemGame->GetAnimations();
+    AtlasRegion sheetRegion = {sheet, {0, 0, frameSize * clipFrames, frameSize}, frameSize * clipFrames, frameSize};
+    int clips[5];
+    for (int i = 0; i < 5; i++) {
+        clips[i] = animations.AddClip(sheetRegion, frameSize, frameSize, clipFrames, 8.0f + i);
+    }
+    for (int i = 0; i < benchSprites; i++) {
+        Actor* actor = new Actor(systemGame);
+        animations.Play(new SpriteComponent(actor), clips[i % 5]);
+    }
+
+    double componentMs = MsPerFrame(benchFrames, [&](int) { componentGame->UpdateActors(fixedDeltaTime); });
+    long changed = 0;
+    double systemMs = MsPerFrame(benchFrames, [&](int) {
+        animations.Update(fixedDeltaTime);
+        changed += animations.GetChangedCount();
+    });
+
+    printf("%d animated sprites, %d frames (%.0f frame changes per update)\n", benchSprites, benchFrames,
+           static_cast<double>(changed) / benchFrames);
+    printf("%-28s %10.3f ms/update\n", "flipbook component", componentMs);
+    printf("%-28s %10.3f ms/update (%.2fx)\n", "animation system", systemMs, componentMs / systemMs);
+
+    for (int i = 0; i < clipFrames; i++) {
+        SDL_DestroyTexture(frameTextures[i]);
+    }
+    SDL_DestroyTexture(sheet);
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    return 0;
+}
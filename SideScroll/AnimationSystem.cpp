@@ -0,0 +1,161 @@
+#include "AnimationSystem.h"
+#include "SpriteComponent.h"
+#include <math.h>
+
+AnimationSystem::AnimationSystem() {
+    mChangedCount = 0;
+}
+
+int AnimationSystem::AddClip(SDL_Texture* texture, int sheetWidth, int sheetHeight, const std::vector<SDL_Rect>& frames,
+                             float framesPerSecond, bool loop) {
+    int firstFrame = static_cast<int>(mFrames.size());
+    mFrames.insert(mFrames.end(), frames.begin(), frames.end());
+    return AddClip(texture, sheetWidth, sheetHeight, firstFrame, framesPerSecond, loop);
+}
+
+int AnimationSystem::AddClip(const AtlasRegion& sheet, int frameWidth, int frameHeight, int frameCount,
+                             float framesPerSecond, bool loop) {
+    int firstFrame = static_cast<int>(mFrames.size());
+    int columns = sheet.rect.w / frameWidth > 0 ? sheet.rect.w / frameWidth : 1;
+    for (int i = 0; i < frameCount; i++) {
+        mFrames.push_back({sheet.rect.x + (i % columns) * frameWidth, sheet.rect.y + (i / columns) * frameHeight,
+                           frameWidth, frameHeight});
+    }
+    return AddClip(sheet.texture, sheet.pageWidth, sheet.pageHeight, firstFrame, framesPerSecond, loop);
+}
+
+int AnimationSystem::AddClip(SDL_Texture* texture, int sheetWidth, int sheetHeight, int firstFrame,
+                             float framesPerSecond, bool loop) {
+    Clip clip;
+    clip.texture = texture;
+    clip.sheetWidth = sheetWidth;
+    clip.sheetHeight = sheetHeight;
+    clip.firstFrame = firstFrame;
+    clip.frameCount = static_cast<int>(mFrames.size()) - firstFrame;
+    clip.framesPerSecond = framesPerSecond;
+    clip.loop = loop;
+    if (clip.frameCount == 0) {
+        SDL_Log("Animation clip has no frames");
+    }
+    mClips.push_back(clip);
+    return static_cast<int>(mClips.size()) - 1;
+}
+
+void AnimationSystem::Play(SpriteComponent* sprite, int clip, float speed) {
+    const Clip& info = mClips[clip];
+    if (info.frameCount == 0) {
+        return;
+    }
+    int row = sprite->GetAnimationIndex();
+    if (row < 0) {
+        row = static_cast<int>(mSprites.size());
+        mTime.push_back(0.0f);
+        mRate.push_back(0.0f);
+        mLength.push_back(0.0f);
+        mFrame.push_back(0);
+        mFrameBase.push_back(0);
+        mClip.push_back(0);
+        mSprites.push_back(sprite);
+        mChanged.push_back(0);
+        sprite->SetAnimationIndex(row);
+    }
+    // backwards starts at the end of the last frame, so it is shown for a whole frame
+    bool reverse = speed < 0.0f;
+    int firstShown = reverse ? info.frameCount - 1 : 0;
+    mTime[row] = reverse ? nextafterf(static_cast<float>(info.frameCount), 0.0f) : 0.0f;
+    mRate[row] = info.framesPerSecond * speed;
+    mLength[row] = info.loop ? static_cast<float>(info.frameCount) : -static_cast<float>(info.frameCount);
+    mFrame[row] = firstShown;
+    mFrameBase[row] = info.firstFrame;
+    mClip[row] = clip;
+    sprite->SetSheetFrame(info.texture, info.sheetWidth, info.sheetHeight, mFrames[info.firstFrame + firstShown]);
+}
+
+void AnimationSystem::Stop(SpriteComponent* sprite) {
+    int row = sprite->GetAnimationIndex();
+    if (row < 0) {
+        return;
+    }
+    // move the last row into the hole
+    int last = static_cast<int>(mSprites.size()) - 1;
+    mTime[row] = mTime[last];
+    mRate[row] = mRate[last];
+    mLength[row] = mLength[last];
+    mFrame[row] = mFrame[last];
+    mFrameBase[row] = mFrameBase[last];
+    mClip[row] = mClip[last];
+    mSprites[row] = mSprites[last];
+    mSprites[row]->SetAnimationIndex(row);
+    mTime.pop_back();
+    mRate.pop_back();
+    mLength.pop_back();
+    mFrame.pop_back();
+    mFrameBase.pop_back();
+    mClip.pop_back();
+    mSprites.pop_back();
+    mChanged.pop_back();
+    sprite->SetAnimationIndex(-1);
+}
+
+void AnimationSystem::SetSpeed(SpriteComponent* sprite, float speed) {
+    int row = sprite->GetAnimationIndex();
+    if (row >= 0) {
+        mRate[row] = mClips[mClip[row]].framesPerSecond * speed;
+    }
+}
+
+bool AnimationSystem::IsFinished(const SpriteComponent* sprite) const {
+    int row = sprite->GetAnimationIndex();
+    if (row < 0 || mLength[row] >= 0.0f) {
+        return false;
+    }
+    return mFrame[row] == (mRate[row] < 0.0f ? 0 : static_cast<int>(-mLength[row]) - 1);
+}
+
+void AnimationSystem::Update(float deltaTime) {
+    int count = static_cast<int>(mSprites.size());
+    float* time = mTime.data();
+    const float* rate = mRate.data();
+    const float* length = mLength.data();
+    int* frame = mFrame.data();
+    int* changed = mChanged.data();
+    int changedCount = 0;
+
+    // advance every clock; rows whose frame changed are appended to changed
+    // (written unconditionally, only the count depends on the comparison)
+    for (int i = 0; i < count; i++) {
+        float t = time[i] + rate[i] * deltaTime;
+        if (length[i] > 0.0f) {
+            if (t >= length[i] || t < 0.0f) {
+                // wraps either way (negative rates play backwards)
+                t = fmodf(t, length[i]);
+                if (t < 0.0f) {
+                    t += length[i];
+                }
+                // a tiny negative t rounds up to length
+                if (t >= length[i]) {
+                    t = 0.0f;
+                }
+            }
+        } else if (t > -length[i] - 1.0f) {
+            // not looping: hold the last frame
+            t = -length[i] - 1.0f;
+        } else if (t < 0.0f) {
+            // or the first, playing backwards
+            t = 0.0f;
+        }
+        time[i] = t;
+        int newFrame = static_cast<int>(t);
+        changed[changedCount] = i;
+        changedCount += newFrame != frame[i];
+        frame[i] = newFrame;
+    }
+
+    // only the sprites that changed frame are touched
+    const SDL_Rect* frames = mFrames.data();
+    for (int i = 0; i < changedCount; i++) {
+        int row = changed[i];
+        mSprites[row]->SetFrameRect(frames[mFrameBase[row] + frame[row]]);
+    }
+    mChangedCount = changedCount;
+}
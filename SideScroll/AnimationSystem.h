@@ -0,0 +1,77 @@
+#pragma once
+#include "SDL/SDL.h"
+#include "TextureAtlas.h"
+#include <vector>
+
+// Flipbook animation for sprites. Clips are frame tables (source rects into
+// one shared texture or atlas page) kept back to back in a single table, and
+// every playing animation is a row of parallel arrays, so one Update advances
+// all the clocks in a tight loop and then touches only the sprites whose
+// frame changed (a rect copy, no texture query).
+// Rows are swap-and-popped on Stop and each sprite knows its row, like the
+// draw list. Animations keep running while their actor is paused; set the
+// speed to 0 to hold a frame.
+class AnimationSystem {
+public:
+    AnimationSystem();
+    // Clip of explicit frames in a sheetWidth x sheetHeight texture; returns its id
+    int AddClip(SDL_Texture* texture, int sheetWidth, int sheetHeight, const std::vector<SDL_Rect>& frames,
+                float framesPerSecond, bool loop = true);
+    // Clip of frameCount equal frames laid out left to right, top to bottom
+    // inside an atlas region (or a whole texture given as a region)
+    int AddClip(const AtlasRegion& sheet, int frameWidth, int frameHeight, int frameCount, float framesPerSecond,
+                bool loop = true);
+    int GetClipCount() const { return static_cast<int>(mClips.size()); }
+
+    // Starts the clip from its first frame on the sprite (replacing its texture);
+    // a negative speed plays it backwards, starting from its last frame
+    void Play(class SpriteComponent* sprite, int clip, float speed = 1.0f);
+    // Stops the sprite's animation, leaving it on its current frame
+    void Stop(class SpriteComponent* sprite);
+    // Negative speeds play backwards from the current frame
+    void SetSpeed(class SpriteComponent* sprite, float speed);
+    // True once a non-looping clip has reached its last frame (its first
+    // when playing backwards)
+    bool IsFinished(const class SpriteComponent* sprite) const;
+
+    // Advances every animation and updates the sprites that changed frame
+    void Update(float deltaTime);
+    int GetPlayingCount() const { return static_cast<int>(mSprites.size()); }
+    // Sprites whose frame changed in the last Update
+    int GetChangedCount() const { return mChangedCount; }
+
+private:
+    struct Clip {
+        SDL_Texture* texture;
+        int sheetWidth;
+        int sheetHeight;
+        // range of the clip in mFrames
+        int firstFrame;
+        int frameCount;
+        float framesPerSecond;
+        bool loop;
+    };
+    // Shared by both AddClip overloads
+    int AddClip(SDL_Texture* texture, int sheetWidth, int sheetHeight, int firstFrame, float framesPerSecond,
+                bool loop);
+
+    std::vector<Clip> mClips;
+    // every clip's frames
+    std::vector<SDL_Rect> mFrames;
+
+    // one row per playing animation:
+    // clock in frames (fractional), and frames advanced per second
+    std::vector<float> mTime;
+    std::vector<float> mRate;
+    // frame count of the clip (as a float for the wrap), negative if it doesn't loop
+    std::vector<float> mLength;
+    // frame shown, and where the clip starts in mFrames
+    std::vector<int> mFrame;
+    std::vector<int> mFrameBase;
+    // clip playing (only read by SetSpeed)
+    std::vector<int> mClip;
+    std::vector<class SpriteComponent*> mSprites;
+    // rows that changed frame in the last Update
+    std::vector<int> mChanged;
+    int mChangedCount;
+};
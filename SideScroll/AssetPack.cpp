@@ -0,0 +1,204 @@
+#include "AssetPack.h"
+#include "SDL/SDL_image.h"
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const uint32_t packVersion = 1;
+
+AssetPack::AssetPack() {
+    mData = nullptr;
+    mSize = 0;
+    mEntries = nullptr;
+    mEntryCount = 0;
+#ifdef _WIN32
+    mFile = INVALID_HANDLE_VALUE;
+    mMapping = nullptr;
+#else
+    mFile = -1;
+#endif
+}
+
+AssetPack::~AssetPack() {
+    Close();
+}
+
+bool AssetPack::Open(const char* fileName) {
+    Close();
+#ifdef _WIN32
+    mFile = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                        nullptr);
+    if (mFile == INVALID_HANDLE_VALUE) {
+        SDL_Log("Failed to open pack %s", fileName);
+        return false;
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(mFile, &size);
+    mSize = static_cast<size_t>(size.QuadPart);
+    mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mMapping) {
+        mData = static_cast<const unsigned char*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    mFile = open(fileName, O_RDONLY);
+    if (mFile < 0) {
+        SDL_Log("Failed to open pack %s", fileName);
+        return false;
+    }
+    struct stat info;
+    fstat(mFile, &info);
+    mSize = static_cast<size_t>(info.st_size);
+    void* data = mSize > 0 ? mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, mFile, 0) : MAP_FAILED;
+    mData = data != MAP_FAILED ? static_cast<const unsigned char*>(data) : nullptr;
+#endif
+    if (!mData) {
+        SDL_Log("Failed to map pack %s", fileName);
+        Close();
+        return false;
+    }
+
+    // validate before trusting any offset
+    const PackHeader* header = reinterpret_cast<const PackHeader*>(mData);
+    // (the directory is read in place, so it must be aligned for PackEntry)
+    if (mSize < sizeof(PackHeader) || memcmp(header->magic, "SSPK", 4) != 0 || header->version != packVersion ||
+        header->directoryOffset > mSize || header->directoryOffset % alignof(PackEntry) != 0 ||
+        header->entryCount > (mSize - header->directoryOffset) / sizeof(PackEntry)) {
+        SDL_Log("%s is not a valid pack file", fileName);
+        Close();
+        return false;
+    }
+    mEntries = reinterpret_cast<const PackEntry*>(mData + header->directoryOffset);
+    mEntryCount = static_cast<int>(header->entryCount);
+    for (int i = 0; i < mEntryCount; i++) {
+        const PackEntry& entry = mEntries[i];
+        // CreateTexture uploads height rows of width ARGB8888 pixels, pitch apart
+        if (entry.format != SDL_PIXELFORMAT_ARGB8888 || static_cast<uint64_t>(entry.width) * 4 > entry.pitch) {
+            SDL_Log("%s has an entry with a bad format or pitch", fileName);
+            Close();
+            return false;
+        }
+        if (entry.offset > mSize || static_cast<uint64_t>(entry.pitch) * entry.height > mSize - entry.offset) {
+            SDL_Log("%s has an entry past the end of the file", fileName);
+            Close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void AssetPack::Close() {
+#ifdef _WIN32
+    if (mData) {
+        UnmapViewOfFile(mData);
+    }
+    if (mMapping) {
+        CloseHandle(mMapping);
+        mMapping = nullptr;
+    }
+    if (mFile != INVALID_HANDLE_VALUE) {
+        CloseHandle(mFile);
+        mFile = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (mData) {
+        munmap(const_cast<unsigned char*>(mData), mSize);
+    }
+    if (mFile >= 0) {
+        close(mFile);
+        mFile = -1;
+    }
+#endif
+    mData = nullptr;
+    mSize = 0;
+    mEntries = nullptr;
+    mEntryCount = 0;
+}
+
+const PackEntry* AssetPack::Find(AssetId id) const {
+    const PackEntry* end = mEntries + mEntryCount;
+    const PackEntry* entry = std::lower_bound(mEntries, end, id,
+                                              [](const PackEntry& e, AssetId value) { return e.id < value; });
+    return entry != end && entry->id == id ? entry : nullptr;
+}
+
+SDL_Texture* AssetPack::CreateTexture(SDL_Renderer* renderer, const PackEntry& entry) const {
+    SDL_Texture* text = SDL_CreateTexture(renderer, entry.format, SDL_TEXTUREACCESS_STATIC, entry.width, entry.height);
+    if (!text) {
+        SDL_Log("Failed to create texture from pack: %s", SDL_GetError());
+        return nullptr;
+    }
+    // the renderer copies straight out of the mapping
+    SDL_UpdateTexture(text, nullptr, GetPixels(entry), entry.pitch);
+    SDL_SetTextureBlendMode(text, SDL_BLENDMODE_BLEND);
+    return text;
+}
+
+bool AssetPack::Write(const char* packName, const std::vector<std::string>& fileNames) {
+    FILE* file = fopen(packName, "wb");
+    if (!file) {
+        SDL_Log("Failed to create pack %s", packName);
+        return false;
+    }
+    PackHeader header = {{'S', 'S', 'P', 'K'}, packVersion, 0, 0, 0};
+    fwrite(&header, sizeof(header), 1, file);
+    uint64_t offset = sizeof(header);
+
+    std::vector<PackEntry> entries;
+    bool ok = true;
+    for (const std::string& fileName : fileNames) {
+        SDL_Surface* loaded = IMG_Load(fileName.c_str());
+        SDL_Surface* surf = loaded ? SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0) : nullptr;
+        SDL_FreeSurface(loaded);
+        if (!surf) {
+            SDL_Log("Failed to load texture file %s", fileName.c_str());
+            ok = false;
+            continue;
+        }
+        // 16-byte alignment for the upload's memcpy
+        static const char zeros[16] = {};
+        uint64_t aligned = (offset + 15) & ~static_cast<uint64_t>(15);
+        fwrite(zeros, 1, static_cast<size_t>(aligned - offset), file);
+        offset = aligned;
+
+        uint32_t pitch = static_cast<uint32_t>(surf->w) * 4;
+        PackEntry entry = {HashAssetName(fileName.c_str()), offset, static_cast<uint32_t>(surf->w),
+                           static_cast<uint32_t>(surf->h), pitch, SDL_PIXELFORMAT_ARGB8888};
+        SDL_LockSurface(surf);
+        for (int row = 0; row < surf->h; row++) {
+            fwrite(static_cast<const unsigned char*>(surf->pixels) + row * surf->pitch, 1, pitch, file);
+        }
+        SDL_UnlockSurface(surf);
+        SDL_FreeSurface(surf);
+        offset += static_cast<uint64_t>(pitch) * entry.height;
+        entries.push_back(entry);
+    }
+
+    // directory sorted by id for binary search
+    std::sort(entries.begin(), entries.end(), [](const PackEntry& a, const PackEntry& b) { return a.id < b.id; });
+    for (size_t i = 1; i < entries.size(); i++) {
+        if (entries[i].id == entries[i - 1].id) {
+            SDL_Log("Asset id collision in pack %s", packName);
+            ok = false;
+        }
+    }
+    uint64_t aligned = (offset + 7) & ~static_cast<uint64_t>(7);
+    static const char zeros[8] = {};
+    fwrite(zeros, 1, static_cast<size_t>(aligned - offset), file);
+    header.directoryOffset = aligned;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    if (!entries.empty()) {
+        fwrite(entries.data(), sizeof(PackEntry), entries.size(), file);
+    }
+    fseek(file, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, file);
+    fclose(file);
+    return ok;
+}
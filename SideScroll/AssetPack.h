@@ -0,0 +1,62 @@
+#pragma once
+#include "SDL/SDL.h"
+#include "TextureLoader.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Pack file layout (little endian, all offsets from the start of the file):
+//   PackHeader
+//   pixel data of every image, each 16-byte aligned, rows of `pitch` bytes
+//   PackEntry[entryCount] sorted by id (the directory)
+// Pixels are stored already decoded in SDL_PIXELFORMAT_ARGB8888, so a texture
+// is created straight from the mapped bytes with no decode step.
+struct PackHeader {
+    char magic[4]; // "SSPK"
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+    uint64_t directoryOffset;
+};
+
+struct PackEntry {
+    AssetId id; // HashAssetName of the file name the image was packed from
+    uint64_t offset;
+    uint32_t width;
+    uint32_t height;
+    uint32_t pitch;
+    uint32_t format;
+};
+
+// Read-only view of a pack file, memory mapped (the OS pages it in on demand
+// and keeps it in its file cache between runs)
+class AssetPack {
+public:
+    AssetPack();
+    ~AssetPack();
+    bool Open(const char* fileName);
+    void Close();
+    bool IsOpen() const { return mData != nullptr; }
+
+    // Binary search of the directory; nullptr if the id isn't in the pack
+    const PackEntry* Find(AssetId id) const;
+    const void* GetPixels(const PackEntry& entry) const { return mData + entry.offset; }
+    // Creates a static texture from the mapped pixels
+    SDL_Texture* CreateTexture(SDL_Renderer* renderer, const PackEntry& entry) const;
+    int GetEntryCount() const { return mEntryCount; }
+
+    // Decodes the files and writes them as a pack (the packer tool)
+    static bool Write(const char* packName, const std::vector<std::string>& fileNames);
+
+private:
+    const unsigned char* mData;
+    size_t mSize;
+    const PackEntry* mEntries;
+    int mEntryCount;
+#ifdef _WIN32
+    void* mFile;
+    void* mMapping;
+#else
+    int mFile;
+#endif
+};
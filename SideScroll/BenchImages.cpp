@@ -0,0 +1,27 @@
+#include "BenchImages.h"
+#include "SDL/SDL_image.h"
+#include <stdlib.h>
+
+bool WriteNoisePngs(const std::string& dir, const char* prefix, int count, int size,
+                    std::vector<std::string>& files) {
+    srand(42);
+    for (int i = 0; i < count; i++) {
+        SDL_Surface* surf = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (!surf) {
+            SDL_Log("Failed to create surface: %s", SDL_GetError());
+            return false;
+        }
+        Uint32* pixels = static_cast<Uint32*>(surf->pixels);
+        for (int p = 0; p < size * size; p++) {
+            pixels[p] = 0xff000000u | ((rand() & 0xff) << 16) | ((p & 0xff) << 8) | (p >> 10 & 0xff);
+        }
+        files.push_back(dir + "/" + prefix + "_" + std::to_string(i) + ".png");
+        if (IMG_SavePNG(surf, files.back().c_str()) != 0) {
+            SDL_Log("Failed to write %s: %s", files.back().c_str(), SDL_GetError());
+            SDL_FreeSurface(surf);
+            return false;
+        }
+        SDL_FreeSurface(surf);
+    }
+    return true;
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Writes count size x size noise PNGs (so decoding them does real work) as
+// dir/<prefix>_<i>.png and appends their names to files. The pixels are the
+// same on every run. Returns false (after logging) if one can't be written.
+bool WriteNoisePngs(const std::string& dir, const char* prefix, int count, int size,
+                    std::vector<std::string>& files);
@@ -0,0 +1,13 @@
+#pragma once
+#include <chrono>
+
+// Runs fn(frame) for frames = 0..frames-1 and returns the average wall time
+// of one call in milliseconds
+template <typename Fn>
+double MsPerFrame(int frames, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        fn(frame);
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1000.0 / frames;
+}
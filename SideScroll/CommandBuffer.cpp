@@ -0,0 +1,77 @@
+#include "CommandBuffer.h"
+#include "../Common/JobSystem.h"
+#include "Game.h"
+#include <algorithm>
+
+CommandBuffers::CommandBuffers() {
+    Resize(1);
+}
+
+void CommandBuffers::Resize(int threadCount) {
+    mBuffers.resize(threadCount > 0 ? threadCount : 1);
+    for (ThreadBuffer& buffer : mBuffers) {
+        buffer.inWorkItem = false;
+        buffer.key = 0;
+        buffer.sequence = 0;
+    }
+}
+
+CommandBuffers::ThreadBuffer& CommandBuffers::Current() {
+    int index = JobSystem::GetThreadIndex();
+    return mBuffers[index < static_cast<int>(mBuffers.size()) ? index : 0];
+}
+
+void CommandBuffers::BeginWorkItem(uint64_t key) {
+    ThreadBuffer& buffer = Current();
+    buffer.inWorkItem = true;
+    buffer.key = key;
+    buffer.sequence = 0;
+}
+
+void CommandBuffers::Spawn(std::function<void(Game*)> fn) {
+    ThreadBuffer& buffer = Current();
+    buffer.commands.push_back({buffer.inWorkItem, buffer.key, buffer.sequence++, ActorHandle(), std::move(fn)});
+}
+
+void CommandBuffers::Destroy(ActorHandle actor) {
+    ThreadBuffer& buffer = Current();
+    buffer.commands.push_back({buffer.inWorkItem, buffer.key, buffer.sequence++, actor, nullptr});
+}
+
+void CommandBuffers::Execute(Game* game) {
+    // take the commands out first: commands run here may record new ones (for next frame)
+    mExecuting.resize(mBuffers.size());
+    mMerged.clear();
+    for (size_t i = 0; i < mBuffers.size(); i++) {
+        mExecuting[i].swap(mBuffers[i].commands);
+        // until the next work item starts, commands are recorded outside the
+        // update (only the main thread runs then, so their sequence is unique)
+        mBuffers[i].inWorkItem = false;
+        mBuffers[i].key = 0;
+        mBuffers[i].sequence = 0;
+        for (Command& command : mExecuting[i]) {
+            mMerged.push_back(&command);
+        }
+    }
+    // (outside the update, work item, sequence) is unique per command, so the
+    // unstable sort gives the same order for any thread count
+    std::sort(mMerged.begin(), mMerged.end(), [](const Command* a, const Command* b) {
+        if (a->inWorkItem != b->inWorkItem) {
+            return !a->inWorkItem;
+        }
+        return a->key != b->key ? a->key < b->key : a->sequence < b->sequence;
+    });
+
+    for (Command* command : mMerged) {
+        if (command->spawn) {
+            command->spawn(game);
+        } else if (Actor* actor = game->GetActor(command->target)) {
+            actor->SetState(Actor::EDead);
+        }
+    }
+
+    // emptied, not freed: the next swap hands them back to the recorders
+    for (std::vector<Command>& commands : mExecuting) {
+        commands.clear();
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "Actor.h"
+#include <functional>
+#include <stdint.h>
+#include <vector>
+
+// Actor creation/destruction requested while components update in parallel.
+// Each thread records into its own buffer (no locks); every command is tagged
+// with the work item it was recorded in, and Execute replays all of them on
+// the main thread sorted by (work item, order within the item). Work item
+// numbering only depends on the scene, so the result is the same for any
+// thread count or timing. Commands recorded outside the update (e.g. by
+// message handlers, or by commands being executed) go first, in the order
+// they were recorded.
+class CommandBuffers {
+public:
+    CommandBuffers();
+    // One buffer per JobSystem thread
+    void Resize(int threadCount);
+    // Starts tagging this thread's commands with key (the scheduler calls it)
+    void BeginWorkItem(uint64_t key);
+
+    // Runs fn(game) at the sync point (e.g. to create an actor)
+    void Spawn(std::function<void(class Game*)> fn);
+    // Marks the actor dead at the sync point (it is reaped the same frame)
+    void Destroy(ActorHandle actor);
+
+    // Applies every recorded command in order and clears the buffers
+    // (main thread, while no work items run)
+    void Execute(class Game* game);
+
+private:
+    struct Command {
+        // false: recorded outside any work item (sorts before all of them)
+        bool inWorkItem;
+        uint64_t key;
+        uint32_t sequence;
+        ActorHandle target; // for Destroy
+        std::function<void(class Game*)> spawn;
+    };
+    struct ThreadBuffer {
+        std::vector<Command> commands;
+        bool inWorkItem;
+        uint64_t key;
+        uint32_t sequence;
+        // keep threads' buffers on separate cache lines
+        char padding[64];
+    };
+    ThreadBuffer& Current();
+
+    std::vector<ThreadBuffer> mBuffers;
+    // commands being applied and their merged order (reused every frame)
+    std::vector<std::vector<Command>> mExecuting;
+    std::vector<Command*> mMerged;
+};
@@ -1,17 +1,40 @@
-class Component {
-public:
-    // Constructor
-    // (the lower the update order, the earlier the component updates)
-    Component(class Actor *owner, int updateOrder = 100);
-    // Destructor
-    virtual ~Component();
-    // Update this component by delta time
-    virtual void Update(float deltaTime);
-    int GetUpdateOrder() const { return mUpdateOrder; }
+#include "Component.h"
+#include "Actor.h"
+#include "ComponentStore.h"
 
-protected:
-    // Owning actor
-    class Actor *mOwner;
-    // Update order of component
-    int mUpdateOrder;
-};
\ No newline at end of file
+Component::Component(Actor* owner, int updateOrder) {
+    mOwner = owner;
+    mUpdateOrder = updateOrder;
+    mPool = nullptr;
+    mPoolSlot = -1;
+    // Add to actor's vector of components
+    mOwner->AddComponent(this);
+}
+
+Component::~Component() {
+    mOwner->RemoveComponent(this);
+}
+
+void Component::Update(float deltaTime) {
+}
+
+void Component::AttachToPool(ComponentPoolBase* pool, int slot) {
+    mPool = pool;
+    mPoolSlot = slot;
+    // the actor stops updating it, the store does it in bulk
+    mOwner->OnComponentPooled(this);
+}
+
+void Component::OnOwnerStateChanged(bool active) {
+    if (mPool) {
+        mPool->SetActive(mPoolSlot, active);
+    }
+}
+
+void Component::Destroy() {
+    if (mPool) {
+        mPool->Destroy(this, mPoolSlot);
+    } else {
+        delete this;
+    }
+}
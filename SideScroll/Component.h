@@ -0,0 +1,61 @@
+#pragma once
+#include "../Common/Arena.h"
+#include <stddef.h>
+
+// Kinds of data a component type's Update reads or writes. The ComponentStore
+// runs types whose accesses don't conflict in the same parallel phase, and
+// splits each type's components across threads. That's only safe if Update
+// touches nothing but the component itself and its own actor; anything that
+// affects other actors, or creates/destroys actors, goes through
+// Game::GetCommands() and is applied at the end of the update.
+enum ComponentData : unsigned {
+    kDataTransform = 1 << 0, // owner position/scale/rotation
+    kDataPhysics = 1 << 1,
+    kDataSprite = 1 << 2,
+    kDataGameplay = 1 << 3,
+    // unknown: runs alone, on one thread
+    kDataAll = ~0u
+};
+
+struct ComponentAccess {
+    unsigned reads;
+    unsigned writes;
+};
+
+class Component {
+public:
+    // Constructor
+    // (the lower the update order, the earlier the component updates)
+    Component(class Actor *owner, int updateOrder = 100);
+    // Destructor
+    virtual ~Component();
+    // Components made with new come from the level pool, like actors
+    // (pooled ones are constructed in place by their ComponentPool)
+    static void* operator new(size_t size) { return GetLevelPool().Allocate(size); }
+    static void* operator new(size_t size, void* place) { return place; }
+    static void operator delete(void* ptr, size_t size) { GetLevelPool().Free(ptr, size); }
+    // Update this component by delta time
+    virtual void Update(float deltaTime);
+    // What Update touches (hide this in a derived type to declare it)
+    static ComponentAccess GetAccess() { return {kDataAll, kDataAll}; }
+    int GetUpdateOrder() const { return mUpdateOrder; }
+    class Actor *GetOwner() const { return mOwner; }
+
+    // Pooled components live in a ComponentPool and are updated in bulk by the
+    // ComponentStore instead of through their actor
+    bool IsPooled() const { return mPool != nullptr; }
+    void AttachToPool(class ComponentPoolBase *pool, int slot);
+    // Called by the owner when it becomes (in)active
+    void OnOwnerStateChanged(bool active);
+    // Destroys the component (returns its slot to the pool, or deletes it)
+    void Destroy();
+
+protected:
+    // Owning actor
+    class Actor *mOwner;
+    // Update order of component
+    int mUpdateOrder;
+    // Pool and slot this component was constructed in (nullptr if heap allocated)
+    class ComponentPoolBase *mPool;
+    int mPoolSlot;
+};
@@ -0,0 +1,128 @@
+#include "BenchUtil.h"
+#include "Game.h"
+#include <algorithm>
+#include <random>
+
+// Updates 100k actors with 3 components each, with components allocated one by
+// one with new (level pool, updated through Actor::Update) vs. stored in typed
+// pools (updated in bulk by the ComponentStore). Back-to-back allocations are
+// the best case for new, so it is also measured with components added to actors
+// in shuffled order, like a level that spawns and equips actors over time.
+const int benchActors = 100000;
+const int benchFrames = 200;
+const float fixedDeltaTime = 1.0f / 60.0f;
+
+class MoveComponent : public Component {
+public:
+    MoveComponent(Actor* owner) : Component(owner, 10), mX(0.0f), mY(0.0f), mVelX(30.0f), mVelY(-20.0f) {}
+    void Update(float deltaTime) override {
+        mX += mVelX * deltaTime;
+        mY += mVelY * deltaTime;
+    }
+
+private:
+    float mX, mY, mVelX, mVelY;
+};
+
+class SpinComponent : public Component {
+public:
+    SpinComponent(Actor* owner) : Component(owner, 20), mAngle(0.0f), mSpeed(1.5f) {}
+    void Update(float deltaTime) override {
+        mAngle += mSpeed * deltaTime;
+        if (mAngle > 6.2831853f) {
+            mAngle -= 6.2831853f;
+        }
+    }
+
+private:
+    float mAngle, mSpeed;
+};
+
+class TimerComponent : public Component {
+public:
+    TimerComponent(Actor* owner) : Component(owner, 30), mRemaining(0.5f), mFired(0) {}
+    void Update(float deltaTime) override {
+        mRemaining -= deltaTime;
+        if (mRemaining <= 0.0f) {
+            mRemaining += 0.5f;
+            mFired++;
+        }
+    }
+
+private:
+    float mRemaining;
+    int mFired;
+};
+
+int main(int argc, char** argv) {
+    // actors are left to process exit, tearing down 100k actors isn't what's measured
+    Game* heapGame = new Game();
+    std::vector<Actor*> heapActors;
+    for (int i = 0; i < benchActors; i++) {
+        Actor* actor = new Actor(heapGame);
+        new MoveComponent(actor);
+        new SpinComponent(actor);
+        new TimerComponent(actor);
+        heapActors.push_back(actor);
+    }
+
+    Game* shuffledGame = new Game();
+    std::vector<Actor*> shuffledActors;
+    for (int i = 0; i < benchActors; i++) {
+        shuffledActors.push_back(new Actor(shuffledGame));
+    }
+    std::vector<int> order(benchActors * 3);
+    for (int i = 0; i < benchActors * 3; i++) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+    for (int i : order) {
+        Actor* actor = shuffledActors[i / 3];
+        switch (i % 3) {
+        case 0:
+            new MoveComponent(actor);
+            break;
+        case 1:
+            new SpinComponent(actor);
+            break;
+        default:
+            new TimerComponent(actor);
+            break;
+        }
+    }
+
+    Game* pooledGame = new Game();
+    ComponentStore& store = pooledGame->GetComponentStore();
+    std::vector<Actor*> pooledActors;
+    for (int i = 0; i < benchActors; i++) {
+        Actor* actor = new Actor(pooledGame);
+        store.Create<MoveComponent>(actor);
+        store.Create<SpinComponent>(actor);
+        store.Create<TimerComponent>(actor);
+        pooledActors.push_back(actor);
+    }
+
+    double heapMs = MsPerFrame(benchFrames, [&](int) {
+        for (Actor* actor : heapActors) {
+            actor->Update(fixedDeltaTime);
+        }
+    });
+    double shuffledMs = MsPerFrame(benchFrames, [&](int) {
+        for (Actor* actor : shuffledActors) {
+            actor->Update(fixedDeltaTime);
+        }
+    });
+    double pooledMs = MsPerFrame(benchFrames, [&](int) {
+        store.UpdateAll(fixedDeltaTime);
+        for (Actor* actor : pooledActors) {
+            actor->Update(fixedDeltaTime);
+        }
+    });
+
+    printf("%d actors x 3 components, %d frames\n", benchActors, benchFrames);
+    printf("%-22s %10.3f ms/frame\n", "new + virtual Update", heapMs);
+    printf("%-22s %10.3f ms/frame\n", "new, shuffled order", shuffledMs);
+    printf("%-22s %10.3f ms/frame (%.2fx / %.2fx)\n", "typed pools, bulk", pooledMs, heapMs / pooledMs,
+           shuffledMs / pooledMs);
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include "ComponentStore.h"
+#include "../Common/Profiler.h"
+
+int ComponentStore::sNextTypeId = 0;
+
+ComponentStore::~ComponentStore() {
+    for (ComponentPoolBase* pool : mPools) {
+        delete pool;
+    }
+}
+
+void ComponentStore::AddPool(ComponentPoolBase* pool) {
+    // keep pools sorted by update order (ties keep creation order)
+    auto iter = mPools.begin();
+    for (; iter != mPools.end(); ++iter) {
+        if (pool->GetUpdateOrder() < (*iter)->GetUpdateOrder()) {
+            break;
+        }
+    }
+    mPools.insert(iter, pool);
+    BuildPhases();
+}
+
+void ComponentStore::BuildPhases() {
+    mPhases.clear();
+    std::vector<int> phaseOf(mPools.size());
+    for (size_t i = 0; i < mPools.size(); i++) {
+        // after the last phase holding an earlier type we conflict with
+        int phase = 0;
+        for (size_t j = 0; j < i; j++) {
+            if (mPools[i]->ConflictsWith(*mPools[j]) && phaseOf[j] + 1 > phase) {
+                phase = phaseOf[j] + 1;
+            }
+        }
+        phaseOf[i] = phase;
+        if (phase == static_cast<int>(mPhases.size())) {
+            mPhases.emplace_back();
+        }
+        mPhases[phase].push_back(static_cast<int>(i));
+    }
+}
+
+void ComponentStore::UpdateAll(float deltaTime, JobSystem* jobs, CommandBuffers* commands) {
+    // work items are numbered across all phases, which orders their commands
+    uint64_t workItemIndex = 0;
+    for (const std::vector<int>& phase : mPhases) {
+        PROFILE_SCOPE("ComponentStore::Phase");
+        mWorkItems.clear();
+        for (int poolIndex : phase) {
+            ComponentPoolBase* pool = mPools[poolIndex];
+            int slots = pool->GetSlotCount();
+            if (!jobs || pool->GetAccess().writes == kDataAll) {
+                // undeclared access: the whole type on one thread
+                mWorkItems.push_back({pool, 0, slots});
+                continue;
+            }
+            for (int begin = 0; begin < slots; begin += kWorkItemSlots) {
+                mWorkItems.push_back({pool, begin, begin + kWorkItemSlots < slots ? begin + kWorkItemSlots : slots});
+            }
+        }
+
+        uint64_t firstItem = workItemIndex;
+        auto run = [&](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                if (commands) {
+                    commands->BeginWorkItem(firstItem + i);
+                }
+                const WorkItem& item = mWorkItems[i];
+                item.pool->UpdateRange(item.begin, item.end, deltaTime);
+            }
+        };
+        int numItems = static_cast<int>(mWorkItems.size());
+        if (jobs) {
+            jobs->ParallelFor(numItems, 1, run);
+        } else {
+            run(0, numItems);
+        }
+        workItemIndex += numItems;
+    }
+}
@@ -0,0 +1,202 @@
+#pragma once
+#include "../Common/JobSystem.h"
+#include "Actor.h"
+#include "CommandBuffer.h"
+#include "Component.h"
+#include <new>
+#include <utility>
+#include <vector>
+
+// Type-erased interface the store uses to update/free a pool
+class ComponentPoolBase {
+public:
+    ComponentPoolBase(int typeId, ComponentAccess access) : mTypeId(typeId), mUpdateOrder(0), mAccess(access) {}
+    virtual ~ComponentPoolBase() {}
+    // Updates live components with an active owner in slots [begin, end)
+    virtual void UpdateRange(int begin, int end, float deltaTime) = 0;
+    // Slots handed out so far (updates only need to look below this)
+    virtual int GetSlotCount() const = 0;
+    // Runs the component's destructor and frees its slot
+    virtual void Destroy(Component* component, int slot) = 0;
+    // Called when the owner's state changes (only active slots update)
+    virtual void SetActive(int slot, bool active) = 0;
+    virtual int GetLiveCount() const = 0;
+    int GetTypeId() const { return mTypeId; }
+    // Update order of the first component created in the pool
+    int GetUpdateOrder() const { return mUpdateOrder; }
+    const ComponentAccess& GetAccess() const { return mAccess; }
+    // True if the two types may update at the same time
+    bool ConflictsWith(const ComponentPoolBase& other) const {
+        return (mAccess.writes & (other.mAccess.reads | other.mAccess.writes)) != 0 ||
+               (other.mAccess.writes & mAccess.reads) != 0;
+    }
+
+protected:
+    int mTypeId;
+    int mUpdateOrder;
+    ComponentAccess mAccess;
+};
+
+// Components of one concrete type stored back to back
+// in fixed-size chunks. Chunks never move, so Component pointers stay valid;
+// freed slots are reused through a free list. Each slot keeps a flag mirroring
+// its owner's state, so the update loop never has to touch the actors.
+template <typename T>
+class ComponentPool : public ComponentPoolBase {
+public:
+    ComponentPool(int typeId) : ComponentPoolBase(typeId, T::GetAccess()), mUsed(0), mLive(0) {}
+
+    ~ComponentPool() {
+        for (Chunk* chunk : mChunks) {
+            delete chunk;
+        }
+    }
+
+    template <typename... Args>
+    T* Create(Actor* owner, Args&&... args) {
+        int slot;
+        if (!mFreeSlots.empty()) {
+            slot = mFreeSlots.back();
+            mFreeSlots.pop_back();
+        } else {
+            slot = mUsed++;
+            if (slot / kChunkSize >= static_cast<int>(mChunks.size())) {
+                mChunks.push_back(new Chunk());
+            }
+        }
+        Chunk* chunk = mChunks[slot / kChunkSize];
+        int index = slot % kChunkSize;
+        T* component = new (chunk->Get(index)) T(owner, std::forward<Args>(args)...);
+        chunk->slotState[index] = owner->GetState() == Actor::EActive ? kSlotActive : kSlotInactive;
+        if (mUsed == 1 && mLive == 0) {
+            mUpdateOrder = component->GetUpdateOrder();
+        }
+        mLive++;
+        component->AttachToPool(this, slot);
+        return component;
+    }
+
+    void UpdateRange(int begin, int end, float deltaTime) override {
+        if (end > mUsed) {
+            end = mUsed;
+        }
+        for (int slot = begin; slot < end;) {
+            Chunk* chunk = mChunks[slot / kChunkSize];
+            int index = slot % kChunkSize;
+            int count = end - slot < kChunkSize - index ? end - slot : kChunkSize - index;
+            for (int i = index; i < index + count; i++) {
+                if (chunk->slotState[i] == kSlotActive) {
+                    // qualified call: no vtable lookup, and it can be inlined
+                    chunk->Get(i)->T::Update(deltaTime);
+                }
+            }
+            slot += count;
+        }
+    }
+
+    int GetSlotCount() const override { return mUsed; }
+
+    void Destroy(Component* component, int slot) override {
+        static_cast<T*>(component)->~T();
+        mChunks[slot / kChunkSize]->slotState[slot % kChunkSize] = kSlotFree;
+        mFreeSlots.push_back(slot);
+        mLive--;
+    }
+
+    void SetActive(int slot, bool active) override {
+        mChunks[slot / kChunkSize]->slotState[slot % kChunkSize] = active ? kSlotActive : kSlotInactive;
+    }
+
+    int GetLiveCount() const override { return mLive; }
+
+private:
+    static const int kChunkSize = 1024;
+    enum SlotState : unsigned char {
+        kSlotFree,
+        kSlotActive,
+        // owner is paused or dead
+        kSlotInactive
+    };
+    struct Chunk {
+        alignas(T) unsigned char storage[kChunkSize * sizeof(T)];
+        SlotState slotState[kChunkSize] = {};
+        T* Get(int index) { return reinterpret_cast<T*>(storage) + index; }
+    };
+
+    std::vector<Chunk*> mChunks;
+    std::vector<int> mFreeSlots;
+    // slots handed out so far (the update loop stops here)
+    int mUsed;
+    int mLive;
+};
+
+// Owns one pool per component type and updates them type by type in update
+// order. Create<T> replaces `new T(owner, ...)`; the component still registers
+// with its actor, so Actor::AddComponent/RemoveComponent keep working.
+// All components of one type are expected to share an update order (the pool
+// takes the order of its first component).
+// Types are grouped into phases from their declared ComponentAccess: a type
+// goes in the first phase after every earlier-ordered type it conflicts with,
+// so conflicting types still run in update order while independent ones share
+// a phase. Each phase runs in parallel on a JobSystem.
+class ComponentStore {
+public:
+    ComponentStore() {}
+    ~ComponentStore();
+
+    template <typename T, typename... Args>
+    T* Create(Actor* owner, Args&&... args) {
+        int typeId = TypeId<T>();
+        ComponentPool<T>* pool = nullptr;
+        for (ComponentPoolBase* existing : mPools) {
+            if (existing->GetTypeId() == typeId) {
+                pool = static_cast<ComponentPool<T>*>(existing);
+                break;
+            }
+        }
+        if (pool) {
+            return pool->Create(owner, std::forward<Args>(args)...);
+        }
+        // new type: its update order is known once the first one is constructed
+        pool = new ComponentPool<T>(typeId);
+        T* component = pool->Create(owner, std::forward<Args>(args)...);
+        AddPool(pool);
+        return component;
+    }
+
+    // Updates all pooled components phase by phase; with a job system each
+    // phase is split into work items across threads, and commands recorded by
+    // a work item are tagged with its (deterministic) index
+    void UpdateAll(float deltaTime, JobSystem* jobs = nullptr, CommandBuffers* commands = nullptr);
+    int GetPoolCount() const { return static_cast<int>(mPools.size()); }
+    int GetPhaseCount() const { return static_cast<int>(mPhases.size()); }
+
+private:
+    template <typename T>
+    static int TypeId() {
+        static const int id = sNextTypeId++;
+        return id;
+    }
+
+    // Inserts after every pool with the same or a lower update order
+    void AddPool(ComponentPoolBase* pool);
+    // Regroups the pools into phases (when a pool is added)
+    void BuildPhases();
+
+    // Slots [begin, end) of one pool, run by one thread
+    struct WorkItem {
+        ComponentPoolBase* pool;
+        int begin;
+        int end;
+    };
+    // slots per work item
+    static const int kWorkItemSlots = 1024;
+
+    static int sNextTypeId;
+    // sorted by update order
+    std::vector<ComponentPoolBase*> mPools;
+    // pool indices per phase
+    std::vector<std::vector<int>> mPhases;
+    // reused every phase
+    std::vector<WorkItem> mWorkItems;
+};
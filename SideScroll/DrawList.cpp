@@ -0,0 +1,98 @@
+#include "DrawList.h"
+#include "SpriteComponent.h"
+
+DrawList::DrawList() {
+    mCount = 0;
+    mDrawn = 0;
+    mCulled = 0;
+}
+
+size_t DrawList::FindBucket(int drawOrder) const {
+    size_t low = 0;
+    size_t high = mBuckets.size();
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (mBuckets[mid].drawOrder < drawOrder) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void DrawList::Add(SpriteComponent* sprite) {
+    int drawOrder = sprite->GetDrawOrder();
+    size_t index = FindBucket(drawOrder);
+    if (index == mBuckets.size() || mBuckets[index].drawOrder != drawOrder) {
+        // first sprite with this draw order
+        mBuckets.insert(mBuckets.begin() + index, Bucket{drawOrder, {}, 0});
+    }
+    Bucket& bucket = mBuckets[index];
+    // holes are normally closed by Draw; without draws (headless) don't let
+    // them pile up (amortized O(1): at least half the bucket is holes)
+    if (bucket.holes > 0 && bucket.holes * 2 >= static_cast<int>(bucket.sprites.size())) {
+        Compact(bucket);
+    }
+    sprite->SetDrawListIndex(static_cast<int>(bucket.sprites.size()));
+    bucket.sprites.emplace_back(sprite);
+    mCount++;
+}
+
+void DrawList::RemoveFromBucket(SpriteComponent* sprite, int drawOrder) {
+    size_t index = FindBucket(drawOrder);
+    if (index == mBuckets.size() || mBuckets[index].drawOrder != drawOrder) {
+        return;
+    }
+    Bucket& bucket = mBuckets[index];
+    int slot = sprite->GetDrawListIndex();
+    if (slot < 0 || slot >= static_cast<int>(bucket.sprites.size()) || bucket.sprites[slot] != sprite) {
+        return;
+    }
+    // leave a hole so the sprites after it keep their stacking order
+    bucket.sprites[slot] = nullptr;
+    bucket.holes++;
+    sprite->SetDrawListIndex(-1);
+    mCount--;
+}
+
+void DrawList::Compact(Bucket& bucket) {
+    int live = 0;
+    for (SpriteComponent* sprite : bucket.sprites) {
+        if (sprite) {
+            sprite->SetDrawListIndex(live);
+            bucket.sprites[live++] = sprite;
+        }
+    }
+    bucket.sprites.resize(live);
+    bucket.holes = 0;
+}
+
+void DrawList::Remove(SpriteComponent* sprite) {
+    RemoveFromBucket(sprite, sprite->GetDrawOrder());
+}
+
+void DrawList::Reorder(SpriteComponent* sprite, int oldDrawOrder) {
+    RemoveFromBucket(sprite, oldDrawOrder);
+    Add(sprite);
+}
+
+void DrawList::Draw(SpriteBatcher& batcher, const SDL_Rect& viewport) {
+    mDrawn = 0;
+    mCulled = 0;
+    for (Bucket& bucket : mBuckets) {
+        if (bucket.holes > 0) {
+            Compact(bucket);
+        }
+        for (SpriteComponent* sprite : bucket.sprites) {
+            sprite->SyncTexture();
+            SDL_Rect bounds = sprite->GetBounds();
+            if (!SDL_HasIntersection(&bounds, &viewport)) {
+                mCulled++;
+                continue;
+            }
+            sprite->Draw(batcher);
+            mDrawn++;
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "SDL/SDL.h"
+#include "SpriteBatcher.h"
+#include <vector>
+
+// Sprites bucketed by draw order for the painter's algorithm. Buckets are kept
+// sorted by draw order (binary search) and each sprite knows its index in its
+// bucket, so add/remove/reorder cost O(log buckets) + O(1) instead of a scan
+// and a vector insert. Sprites with the same draw order draw in the order they
+// were added: a removed sprite leaves a hole, and Draw closes a bucket's holes
+// in one pass before walking it.
+class DrawList {
+public:
+    DrawList();
+    void Add(class SpriteComponent* sprite);
+    void Remove(class SpriteComponent* sprite);
+    // Moves a sprite whose draw order changed from oldDrawOrder to its new bucket
+    void Reorder(class SpriteComponent* sprite, int oldDrawOrder);
+
+    // Queues sprites back to front, skipping those whose bounds miss the
+    // viewport (the world-space rectangle the camera sees)
+    void Draw(SpriteBatcher& batcher, const SDL_Rect& viewport);
+
+    int GetSpriteCount() const { return mCount; }
+    // Sprites drawn/culled by the last Draw
+    int GetDrawnCount() const { return mDrawn; }
+    int GetCulledCount() const { return mCulled; }
+
+private:
+    struct Bucket {
+        int drawOrder;
+        // in insertion order; nullptr where a sprite was removed
+        std::vector<class SpriteComponent*> sprites;
+        int holes;
+    };
+    // First bucket with a draw order >= drawOrder
+    size_t FindBucket(int drawOrder) const;
+    void RemoveFromBucket(class SpriteComponent* sprite, int drawOrder);
+    // Closes the bucket's holes, keeping the order (and updating the indices)
+    void Compact(Bucket& bucket);
+
+    // sorted by draw order (empty buckets are kept, there are only a few orders)
+    std::vector<Bucket> mBuckets;
+    int mCount;
+    int mDrawn;
+    int mCulled;
+};
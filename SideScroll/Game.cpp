@@ -1,14 +1,49 @@
 #include "Game.h"
+#include "../Common/AllocCounter.h"
+#include "../Common/Profiler.h"
 #include "SDL/SDL_image.h"
 #include <algorithm>
+#include <thread>
 
 const float windowWidth = 1024;
 const float windowHeight = 700;
+// time per frame the main thread may spend creating streamed textures
+const float textureUploadBudgetMs = 2.0f;
+// frame time of the update thread when there's a render thread (the
+// single-threaded loop is paced by vsync instead)
+const float simulationFrameMs = 1000.0f / 60.0f;
+// command order key of the serial part of the update (after any work item)
+const uint64_t serialWorkItem = ~0ull;
+// built with: pack_tool Assets/level.pack Assets/*.png
+const char* levelPackName = "Assets/level.pack";
+
+// Posted for every actor created while the actors update
+struct ActorCreatedMessage {
+    ActorHandle actor;
+};
 
 Game::Game() {
     mWindow = nullptr;
     mIsRunning = true;
     mTicksCount = 0;
+    mUpdatingActors = false;
+    mPendingActorCount = 0;
+    mFrameAllocations = 0;
+    mMaxFrameAllocations = 0;
+    mCameraPosition = {0.0f, 0.0f};
+    mJobs = nullptr;
+    mRenderThread = false;
+    mFrameNumber = 0;
+    // actors created during the update join mActors when its messages are
+    // dispatched (unless they were deleted again before that)
+    mMessages.Subscribe<ActorCreatedMessage>([this](const ActorCreatedMessage& message) {
+        Actor* actor = GetActor(message.actor);
+        if (actor) {
+            mPendingActorCount--;
+            actor->SetListIndex(static_cast<int>(mActors.size()), false);
+            mActors.emplace_back(actor);
+        }
+    });
 }
 
 bool Game::Initialize() {
@@ -39,7 +74,7 @@ bool Game::Initialize() {
     mRenderer = SDL_CreateRenderer(
         mWindow,                                               // Window to create renderer for
         -1,                                                    // specifies which graphics driver to use; -1 only a single window [let SDL decide]
-        SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC); // initialization flags
+        SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC | SDL_RENDERER_TARGETTEXTURE); // initialization flags (tile layers render into textures)
 
     if (!mRenderer) {
         SDL_Log("Failed to create renderer: %s", SDL_GetError());
@@ -51,27 +86,177 @@ bool Game::Initialize() {
         return false;
     }
 
+    // keep one core for the main thread
+    int decodeThreads = SDL_GetCPUCount() - 1;
+    if (!mTextureLoader.Initialize(mRenderer, decodeThreads > 1 ? decodeThreads : 1)) {
+        return false;
+    }
+
     LoadData();
 
     return true;
 }
 
 void Game::RunLoop() {
+    if (mRenderThread) {
+        RunThreaded();
+        return;
+    }
     // run iterations of gameloop until mIsRunning == false
+    int frame = 0;
     while (mIsRunning) {
+        uint64_t allocationsBefore = AllocCounter::GetCount();
         ProcessInput();
         UpdateGame();
         GenerateOutput();
+        PROFILE_END_FRAME();
+        mFrameAllocations = AllocCounter::GetCount() - allocationsBefore;
+        // the first frames are expected to grow arenas and vectors
+        if (++frame > 60 && mFrameAllocations > mMaxFrameAllocations) {
+            mMaxFrameAllocations = mFrameAllocations;
+        }
+    }
+}
+
+void Game::SetRenderThread(bool enabled) {
+    mRenderThread = enabled;
+    // textures are then created and destroyed on the render thread only
+    mTextureLoader.SetRenderThread(enabled);
+}
+
+void Game::RunThreaded() {
+    mFrameMailbox.Reset();
+    for (RenderFrame& frame : mRenderFrames) {
+        frame.sprites.SetImmediate(mSpriteBatcher.IsImmediate());
+        frame.sprites.Clear();
+    }
+    std::thread simulation(&Game::SimulationLoop, this);
+    // this thread created the window: events and drawing stay here
+    while (mIsRunning) {
+        ProcessInput();
+        PresentFrame();
+        PROFILE_END_FRAME();
+    }
+    simulation.join();
+
+    FrameMailboxStats stats = mFrameMailbox.GetStats();
+    SDL_Log("Render thread: %llu frames published, %llu presented, %llu dropped, %llu duplicated, "
+            "latency %.2f ms avg, %.2f ms max",
+            static_cast<unsigned long long>(stats.published), static_cast<unsigned long long>(stats.presented),
+            static_cast<unsigned long long>(stats.dropped), static_cast<unsigned long long>(stats.duplicated),
+            stats.averageLatencyMs, stats.maxLatencyMs);
+}
+
+void Game::SimulationLoop() {
+    int frame = 0;
+    while (mIsRunning) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        // (the counter is global, so this includes the render thread's allocations meanwhile)
+        uint64_t allocationsBefore = AllocCounter::GetCount();
+        // textures the render thread uploaded since the last frame
+        mTextureLoader.SetRecordingFrame(mFrameNumber);
+        mTextureLoader.ApplyUploads();
+        UpdateGame();
+
+        // record the frame for the render thread (the buffer may come back
+        // unflushed when the render thread skipped its frame)
+        RenderFrame& output = mRenderFrames[mFrameMailbox.GetWriteIndex()];
+        output.sprites.Clear();
+        output.camera = mCameraPosition;
+        output.number = mFrameNumber++;
+        RecordSprites(output.sprites);
+        mFrameMailbox.Publish();
+
+        mFrameAllocations = AllocCounter::GetCount() - allocationsBefore;
+        if (++frame > 60 && mFrameAllocations > mMaxFrameAllocations) {
+            mMaxFrameAllocations = mFrameAllocations;
+        }
+        // vsync no longer paces the update: sleep out the rest of its frame
+        float elapsedMs = (SDL_GetPerformanceCounter() - start) * 1000.0f / SDL_GetPerformanceFrequency();
+        if (elapsedMs < simulationFrameMs) {
+            SDL_Delay(static_cast<Uint32>(simulationFrameMs - elapsedMs));
+        }
+    }
+}
+
+void Game::PresentFrame() {
+    PROFILE_SCOPE("Game::PresentFrame");
+    // wait up to a frame for the update; with nothing new the screen keeps
+    // showing the last frame (and events are polled again)
+    int index;
+    {
+        PROFILE_SCOPE("FrameMailbox::Acquire");
+        index = mFrameMailbox.Acquire(simulationFrameMs);
+    }
+    if (index >= 0) {
+        // older frames are never drawn again, so textures evicted before this
+        // one was recorded can be destroyed
+        mTextureLoader.SetDrawingFrame(mRenderFrames[index].number);
     }
+    // create the textures that finished decoding (the update hands them to
+    // their sprites next frame)
+    mTextureLoader.Upload(textureUploadBudgetMs);
+    if (index < 0) {
+        return;
+    }
+    DrawFrame(mRenderFrames[index].sprites, mRenderFrames[index].camera);
 }
 
 void Game::Shutdown() {
+    PROFILE_WRITE_REPORTS("sidescroll_profile");
+    if (mMaxFrameAllocations > 0) {
+        SDL_Log("Steady-state frames made up to %llu heap allocations", (unsigned long long)mMaxFrameAllocations);
+    }
+    UnloadData();
+    mTextureLoader.Shutdown();
     SDL_DestroyRenderer(mRenderer); // destory renderer
     SDL_DestroyWindow(mWindow);     // destory window
     SDL_Quit();                     // closes SDL
 }
 
+void Game::LoadData() {
+    // textures in the level pack skip the PNG decode (optional: without it
+    // everything streams from the loose files)
+    FILE* pack = fopen(levelPackName, "rb");
+    if (pack) {
+        fclose(pack);
+        if (mAssetPack.Open(levelPackName)) {
+            mTextureLoader.MountPack(&mAssetPack);
+        }
+    }
+    // level images are queued with mAtlas.AddFile(...) and packed here,
+    // sprites then use GetAtlasRegion instead of GetTexture
+    mAtlas.Build(mRenderer);
+    // scenery goes in tile layers, e.g. AddTileLayer(0.5f)->Load("Assets/Background.csv")
+    // with SetTileset(region->texture, region->rect) from the atlas
+    // level actors are created here (their textures stream in as they're
+    // requested, mTextureLoader.Finish() waits for all of them)
+}
+
+void Game::UnloadData() {
+    // Delete actors
+    // (each actor removes itself from mActors in its destructor)
+    while (!mActors.empty()) {
+        delete mActors.back();
+    }
+    // every actor and heap component is gone: drop the level's memory at once
+    if (!GetLevelPool().Release()) {
+        SDL_Log("Level pool still has %d live objects", GetLevelPool().GetLiveCount());
+    }
+    for (auto layer : mTileLayers) {
+        delete layer;
+    }
+    mTileLayers.clear();
+    mAtlas.Clear();
+    // the actors' handles are gone; the loader itself lives until Shutdown
+    // so another level can be loaded
+    mTextureLoader.Clear();
+    mTextureLoader.MountPack(nullptr);
+    mAssetPack.Close();
+}
+
 void Game::ProcessInput() {
+    PROFILE_SCOPE("Game::ProcessInput");
     SDL_Event event;
     // While there are still events in the queue
     while (SDL_PollEvent(&event)) {
@@ -89,27 +274,10 @@ void Game::ProcessInput() {
     if (state[SDL_SCANCODE_ESCAPE]) {
         mIsRunning = false;
     }
-
-    // updates mPaddleDir based on input
-    // add/subtract from mPaddleDir ensures that if both keys pressed mPaddleDir is zero
-    mPaddleDir1 = 0;
-    if (state[SDL_SCANCODE_W]) {
-        mPaddleDir1 -= 1;
-    }
-    if (state[SDL_SCANCODE_S]) {
-        mPaddleDir1 += 1;
-    }
-
-    mPaddleDir2 = 0;
-    if (state[SDL_SCANCODE_UP]) {
-        mPaddleDir2 -= 1;
-    }
-    if (state[SDL_SCANCODE_DOWN]) {
-        mPaddleDir2 += 1;
-    }
 }
 
 void Game::UpdateGame() {
+    PROFILE_SCOPE("Game::UpdateGame");
     // Compute delta time
     float deltaTime = (SDL_GetTicks() - mTicksCount) / 1000.0f;
     // Clamp maximum delta time value (never jump ahead too far)
@@ -117,33 +285,80 @@ void Game::UpdateGame() {
         deltaTime = 0.05f;
     }
 
+    mTicksCount = SDL_GetTicks();
+
+    UpdateActors(deltaTime);
+    // flipbooks after the actors, so a clip started this frame shows its first frame
+    mAnimations.Update(deltaTime);
+    // world transforms of everything that moved, for drawing and next frame's reads
+    mTransforms.Update();
+}
+
+void Game::UpdateActors(float deltaTime) {
     // Update all actors
     mUpdatingActors = true;
+    // pooled components first, phase by phase (in parallel with a job system)
+    mComponentStore.UpdateAll(deltaTime, mJobs, &mCommands);
+    // then each actor's heap-allocated components and UpdateActor, serially
+    // (their commands sort after every parallel work item's)
+    mCommands.BeginWorkItem(serialWorkItem);
     for (auto actor : mActors) {
         actor->Update(deltaTime);
     }
 
     mUpdatingActors = false;
-    // Move any pending actors to mActors
-    for (auto pending : mPendingActors) {
-        mActors.emplace_back(pending);
+    // Sync point: apply the actor creation/destruction recorded this update
+    mCommands.Execute(this);
+    // Deliver this update's messages (which also moves the actors created
+    // during it into mActors)
+    {
+        PROFILE_SCOPE("MessageBus::Dispatch");
+        mMessages.Dispatch();
     }
-    mPendingActors.clear();
 
-    // Add any dead actors to a temp vector
-    std::vector<Actor*> deadActors;
+    // Compact live actors to the front in one pass and collect the dead ones
+    Actor** deadActors = mFrameArena.AllocateArray<Actor*>(mActors.size());
+    size_t deadCount = 0;
+    size_t live = 0;
     for (auto actor : mActors) {
         if (actor->GetState() == Actor::EDead) {
-            deadActors.emplace_back(actor);
+            // already out of mActors, so RemoveActor only frees its handle
+            actor->SetListIndex(-1, false);
+            deadActors[deadCount++] = actor;
+        } else {
+            actor->SetListIndex(static_cast<int>(live), false);
+            mActors[live++] = actor;
         }
     }
-    // Delete dead actors (which removes them from mActors)
-    for (auto actor : deadActors) {
-        delete actor;
+    mActors.resize(live);
+    // Delete dead actors
+    for (size_t i = 0; i < deadCount; i++) {
+        delete deadActors[i];
     }
+
+    // end of the update: everything in the frame arena is dropped
+    mFrameArena.Reset();
 }
 
 void Game::GenerateOutput() {
+    PROFILE_SCOPE("Game::GenerateOutput");
+    // swap in textures that finished decoding (bounded, so new assets don't hitch)
+    mTextureLoader.Upload(textureUploadBudgetMs);
+    RecordSprites(mSpriteBatcher);
+    DrawFrame(mSpriteBatcher, mCameraPosition);
+}
+
+void Game::RecordSprites(SpriteBatcher& batcher) {
+    // back to front, culling sprites the camera can't see
+    SDL_Rect viewport;
+    viewport.x = static_cast<int>(mCameraPosition.x);
+    viewport.y = static_cast<int>(mCameraPosition.y);
+    viewport.w = static_cast<int>(windowWidth);
+    viewport.h = static_cast<int>(windowHeight);
+    mSprites.Draw(batcher, viewport);
+}
+
+void Game::DrawFrame(SpriteBatcher& sprites, const Vector2& camera) {
     // clear back buffer to a color
     SDL_SetRenderDrawColor( // specify a color (blue)
         mRenderer,          // pointer to renderer
@@ -154,69 +369,102 @@ void Game::GenerateOutput() {
     );
     SDL_RenderClear(mRenderer); // clear the back buffer to the current draw color
 
-    for (auto& i : mSprites) {
-        i.Draw(mRenderer);
+    // scenery first: only the chunks under the camera
+    for (auto layer : mTileLayers) {
+        layer->Draw(mRenderer, camera, static_cast<int>(windowWidth), static_cast<int>(windowHeight));
     }
-   
+
+    // then the sprites recorded for this frame
+    sprites.Flush(mRenderer);
+
     // swap the front and back buffers
     SDL_RenderPresent(mRenderer);
 }
 
+void Game::SetJobSystem(JobSystem* jobs) {
+    mJobs = jobs;
+    mCommands.Resize(jobs ? jobs->GetThreadCount() : 1);
+    mMessages.SetThreadCount(jobs ? jobs->GetThreadCount() : 1);
+}
+
 void Game::AddActor(Actor* actor) {
-    // If updating actors, need to add to pending
+    // Give the actor a handle slot (reusing freed ones)
+    ActorHandle handle;
+    if (!mFreeActorSlots.empty()) {
+        handle.index = mFreeActorSlots.back();
+        mFreeActorSlots.pop_back();
+    } else {
+        handle.index = static_cast<int>(mActorSlots.size());
+        mActorSlots.push_back({nullptr, 0});
+    }
+    mActorSlots[handle.index].actor = actor;
+    handle.generation = mActorSlots[handle.index].generation;
+    actor->SetHandle(handle);
+
+    // If updating actors, it's added when the update's messages are dispatched
     if (mUpdatingActors) {
-        mPendingActors.emplace_back(actor);
+        actor->SetListIndex(-1, true);
+        mPendingActorCount++;
+        mMessages.Post(ActorCreatedMessage{handle});
     } else {
+        actor->SetListIndex(static_cast<int>(mActors.size()), false);
         mActors.emplace_back(actor);
     }
 }
 
 void Game::RemoveActor(Actor* actor) {
-    // search in updating actors
-    auto pos = std::find(mActors.begin(), mActors.end(), actor);
-    if (pos != mActors.end()) {
-        mActors.erase(pos);
-    } else {
-        pos = std::find(mPendingActors.begin(), mPendingActors.end(), actor);
-        mPendingActors.erase(pos);
+    // swap-and-pop out of mActors (a pending actor isn't in it yet; its
+    // message finds the handle stale)
+    int index = actor->GetListIndex();
+    if (actor->IsPending()) {
+        mPendingActorCount--;
+        actor->SetListIndex(-1, false);
+    } else if (index >= 0) {
+        Actor* last = mActors.back();
+        mActors[index] = last;
+        last->SetListIndex(index, false);
+        mActors.pop_back();
+        actor->SetListIndex(-1, false);
     }
-}
 
-SDL_Texture* Game::GetTexture(const char* fileName) {
-    auto pos = mTextures.find(fileName);
-    if (pos != mTextures.end()) { // if found
-        return pos->second;
-    }
+    // invalidate outstanding handles and recycle the slot
+    ActorHandle handle = actor->GetHandle();
+    mActorSlots[handle.index].actor = nullptr;
+    mActorSlots[handle.index].generation++;
+    mFreeActorSlots.emplace_back(handle.index);
+}
 
-    // if not found load from file
-    SDL_Surface* surf = IMG_Load(fileName);
-    if (!surf) {
-        SDL_Log("Failed to load texture file %s", fileName);
-        return nullptr;
-    }
-    // Create texture from surface
-    SDL_Texture* text = SDL_CreateTextureFromSurface(mRenderer, surf);
-    SDL_FreeSurface(surf);
-    if (!text) {
-        SDL_Log("Failed to convert surface to texture for %s", fileName);
+Actor* Game::GetActor(ActorHandle handle) const {
+    if (handle.index < 0 || handle.index >= static_cast<int>(mActorSlots.size())) {
         return nullptr;
     }
+    const ActorSlot& slot = mActorSlots[handle.index];
+    return slot.generation == handle.generation ? slot.actor : nullptr;
+}
 
-    mTextures.emplace(fileName, text);
+TextureHandle Game::GetTexture(const char* fileName) {
+    return mTextureLoader.Request(fileName);
+}
 
-    return text;
+TextureHandle Game::GetTexture(AssetId id, const char* fileName) {
+    return mTextureLoader.Request(id, fileName);
+}
+
+TileLayer* Game::AddTileLayer(float parallax) {
+    TileLayer* layer = new TileLayer();
+    layer->SetParallax(parallax);
+    mTileLayers.push_back(layer);
+    return layer;
 }
 
 void Game::AddSprite(SpriteComponent* sprite) {
-    // Find the insertion point in the sorted vector
-    // (The first element with a higher draw order than me)
-    int myDrawOrder = sprite->GetDrawOrder();
-    auto iter = mSprites.begin();
-    for (; iter != mSprites.end(); ++iter) {
-        if (myDrawOrder < (*iter)->GetDrawOrder()) {
-            break;
-        }
-    }
-    // Inserts element before position of iterator
-    mSprites.insert(iter, sprite);
+    mSprites.Add(sprite);
+}
+
+void Game::RemoveSprite(SpriteComponent* sprite) {
+    mSprites.Remove(sprite);
+}
+
+void Game::ReorderSprite(SpriteComponent* sprite, int oldDrawOrder) {
+    mSprites.Reorder(sprite, oldDrawOrder);
 }
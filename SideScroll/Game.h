@@ -1,7 +1,22 @@
 #pragma once
+#include "../Common/Arena.h"
+#include "../Common/FrameMailbox.h"
+#include "../Common/JobSystem.h"
 #include "Actor.h"
-#include ""
+#include "AnimationSystem.h"
+#include "AssetPack.h"
+#include "CommandBuffer.h"
+#include "ComponentStore.h"
+#include "DrawList.h"
+#include "MessageBus.h"
+#include "SpriteBatcher.h"
+#include "SpriteComponent.h"
+#include "TextureAtlas.h"
+#include "TextureLoader.h"
+#include "TileLayer.h"
+#include "TransformSystem.h"
 #include <SDL2/SDL.h>
+#include <atomic>
 #include <cmath>
 #include <stdio.h>
 #include <stdlib.h>
@@ -9,11 +24,6 @@
 #include <time.h>
 #include <unordered_map>
 
-struct Vector2 {
-    float x;
-    float y;
-};
-
 class Game {
 public:
     Game();
@@ -21,38 +31,166 @@ public:
     bool Initialize();
     // Runs the game loop until the game is over
     void RunLoop();
+    // Run the update on its own thread while RunLoop's thread handles events,
+    // uploads streamed textures and draws: each frame's sprite quads are
+    // recorded into one of three batchers handed over through a FrameMailbox,
+    // and the newest complete one is drawn (tile layers are baked and drawn
+    // there too), so a present blocked on vsync no longer stalls the update.
+    // SDL wants events and the renderer on the thread that created the
+    // window, so that thread stays the render thread. Call before RunLoop.
+    void SetRenderThread(bool enabled);
+    // Frames handed to the render thread (latency, dropped/duplicated frames)
+    FrameMailboxStats GetRenderThreadStats() const { return mFrameMailbox.GetStats(); }
     // Shutdown the game
     void Shutdown();
 
+    // add/remove actor to mActors; actors created during the update are added
+    // when the update's messages are dispatched
+    // (called by the Actor constructor/destructor, O(1): removal swaps the last
+    // actor into the hole, so mActors is not kept in creation order)
+    void AddActor(Actor* actor);
+    void RemoveActor(Actor* actor);
+    // Actor the handle refers to, or nullptr if it has been deleted
+    Actor* GetActor(ActorHandle handle) const;
+    // Updated actors (not in creation order, see RemoveActor)
+    const std::vector<Actor*>& GetActors() const { return mActors; }
+    int GetActorCount() const { return static_cast<int>(mActors.size()) + mPendingActorCount; }
+
+    // Local/world transforms of every actor (world ones are recomputed once per
+    // frame, after the update)
+    TransformSystem& GetTransforms() { return mTransforms; }
+
+    // One simulation step for all actors: update, dispatch messages (which also
+    // adds the actors created during the update), reap dead
+    // (UpdateGame after computing delta time; benchmarks call it directly)
+    void UpdateActors(float deltaTime);
+
+    // Sprite components register themselves for drawing
+    void AddSprite(SpriteComponent* sprite);
+    void RemoveSprite(SpriteComponent* sprite);
+    void ReorderSprite(SpriteComponent* sprite, int oldDrawOrder);
+    // Starts loading the file in the background if it's new; the asset holds a
+    // placeholder texture until it has been uploaded (the handle keeps it cached)
+    TextureHandle GetTexture(const char* fileName);
+    TextureHandle GetTexture(AssetId id, const char* fileName);
+    // Texture cache budget and hit/miss/eviction counters
+    TextureLoader& GetTextureLoader() { return mTextureLoader; }
+    // Image packed into the level's atlas in LoadData (nullptr if it wasn't)
+    const AtlasRegion* GetAtlasRegion(const char* fileName) const { return mAtlas.Find(fileName); }
+    // Flipbook clips and the sprites playing them (advanced after the actors)
+    AnimationSystem& GetAnimations() { return mAnimations; }
+    // Adds a background layer (owned by the game until UnloadData); layers are
+    // drawn in the order added, behind every sprite. With a render thread they
+    // are baked and drawn on it, so only change them in LoadData.
+    TileLayer* AddTileLayer(float parallax = 1.0f);
+    // Draw call/texture switch counts of the last frame are in GetStats()
+    // (without a render thread; its frames copy the immediate mode setting)
+    SpriteBatcher& GetSpriteBatcher() { return mSpriteBatcher; }
+    // Top left corner of the view in world space (sprites outside it are culled)
+    const Vector2& GetCameraPosition() const { return mCameraPosition; }
+    void SetCameraPosition(const Vector2& position) { mCameraPosition = position; }
+
+    // Runs pooled component phases on these threads (nullptr = single-threaded;
+    // the job system is owned by the caller)
+    void SetJobSystem(JobSystem* jobs);
+    // Actor creation/destruction from inside component updates
+    CommandBuffers& GetCommands() { return mCommands; }
+    // Messages between actors and components (post any time, including from
+    // parallel phases; handlers run once the actors have updated)
+    MessageBus& GetMessages() { return mMessages; }
+
+    // Scratch memory that lives until the end of the current update
+    LinearArena& GetFrameArena() { return mFrameArena; }
+    // Heap allocations made during the last full frame (0 in steady state)
+    uint64_t GetFrameAllocations() const { return mFrameAllocations; }
+
+    // Contiguous per-type storage for components
+    // (GetComponentStore().Create<T>(actor, ...) instead of new T(actor, ...))
+    ComponentStore& GetComponentStore() { return mComponentStore; }
+
 private:
     // Helper functions for the game loop
     void ProcessInput();
     void UpdateGame();
     void GenerateOutput();
+    // RunLoop with the update on its own thread (see SetRenderThread)
+    void RunThreaded();
+    // Update thread: updates and publishes each frame's sprites
+    void SimulationLoop();
+    // Render thread: uploads textures, draws and presents the newest published frame
+    void PresentFrame();
+    // Queues the sprites the camera can see, back to front
+    void RecordSprites(SpriteBatcher& batcher);
+    // Clears, draws the tile layers and the sprites seen from camera, presents
+    void DrawFrame(SpriteBatcher& sprites, const Vector2& camera);
+    // Create/destroy the level's actors
+    void LoadData();
+    void UnloadData();
     // Window created by SDL
     SDL_Window* mWindow;
     // draws graphics
     SDL_Renderer* mRenderer;
-    // Game should continue to run
-    bool mIsRunning;
+    // Game should continue to run (either thread may end it)
+    std::atomic<bool> mIsRunning;
     Uint32 mTicksCount;
 
     bool mUpdatingActors; // if currently updating all mActors
-    // add/remove actor to mPendingActors or mActors
-    void AddActor(Actor* actor);
-    void RemoveActor(Actor* actor);
 
-    SDL_Texture* GetTexture(const char* fileName);
-    void AddSprite(SpriteComponent* sprite);
+    // if looping over mActors a new actor is created, it is announced with a
+    // message instead: cannot add it to mActors because it is being iterated over
+    std::vector<Actor*> mActors; // active actors
+    int mPendingActorCount;      // created this update, not in mActors yet
+    // per-frame scratch allocations, reset at the end of every update
+    LinearArena mFrameArena;
+    // heap allocations in the last frame and the worst frame so far
+    uint64_t mFrameAllocations;
+    uint64_t mMaxFrameAllocations;
+
+    // every actor's transform (declared before anything that can own actors)
+    TransformSystem mTransforms;
+
+    // handle slots: the actor in each slot and the slot's current generation
+    struct ActorSlot {
+        Actor* actor;
+        unsigned int generation;
+    };
+    std::vector<ActorSlot> mActorSlots;
+    std::vector<int> mFreeActorSlots;
+
+    // pooled components, updated in bulk before the actors
+    ComponentStore mComponentStore;
+    JobSystem* mJobs;
+    // commands recorded during the update, applied at its end
+    CommandBuffers mCommands;
+    // messages posted during the update, dispatched after it
+    MessageBus mMessages;
 
-    // if looping over mActors a new actor is created, it is added to mPendingActor
-    // cannot add it to mActors because it is being iterated over
-    std::vector<Actor*> mActors;        // active actors
-    std::vector<Actor*> mPendingActors; // pending actors
+    // All the sprite components drawn, bucketed by draw order
+    DrawList mSprites;
+    // batches the visible sprites into one draw per atlas page
+    SpriteBatcher mSpriteBatcher;
+    // animated sprites, advanced in one pass per frame
+    AnimationSystem mAnimations;
+    // static scenery, back to front (baked into chunk textures)
+    std::vector<TileLayer*> mTileLayers;
+    // the level's images packed into a few textures
+    TextureAtlas mAtlas;
+    Vector2 mCameraPosition;
 
-    // All the sprite components drawn
-	std::vector<class SpriteComponent*> mSprites;
+    // decodes textures on worker threads, uploads a few per frame
+    TextureLoader mTextureLoader;
+    // pre-decoded level textures (made with pack_tool), mapped into memory
+    AssetPack mAssetPack;
 
-    // map of filenames to SDL_Texture pointers
-    std::unordered_map<std::string, SDL_Texture*> mTextures;
+    // render thread: frames recorded by the update thread, handed over by mFrameMailbox
+    struct RenderFrame {
+        SpriteBatcher sprites;
+        Vector2 camera;
+        uint64_t number;
+    };
+    bool mRenderThread;
+    RenderFrame mRenderFrames[3];
+    FrameMailbox mFrameMailbox;
+    // frames recorded so far (the number of the next one)
+    uint64_t mFrameNumber;
 };
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "MessageBus.h"
+
+std::atomic<int> MessageBus::sNextTypeId(0);
+
+MessageBus::~MessageBus() {
+    for (MessageQueueBase* queue : mOrder) {
+        delete queue;
+    }
+}
+
+void MessageBus::SetThreadCount(int threadCount) {
+    mThreadCount = threadCount;
+    for (MessageQueueBase* queue : mOrder) {
+        queue->SetThreadCount(threadCount);
+    }
+}
+
+void MessageBus::Dispatch() {
+    size_t dispatched = 0;
+    // a handler may post a type whose queue already ran: go round again until
+    // a whole pass delivers nothing
+    bool delivered = true;
+    while (delivered) {
+        delivered = false;
+        for (MessageQueueBase* queue : mOrder) {
+            size_t count = queue->Deliver();
+            dispatched += count;
+            delivered = delivered || count > 0;
+        }
+    }
+    for (MessageQueueBase* queue : mOrder) {
+        queue->Reset();
+    }
+    mDispatched = dispatched;
+}
+
+size_t MessageBus::GetDroppedCount() const {
+    size_t dropped = 0;
+    for (MessageQueueBase* queue : mOrder) {
+        dropped += queue->GetDropped();
+    }
+    return dropped;
+}
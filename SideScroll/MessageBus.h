@@ -0,0 +1,281 @@
+#pragma once
+#include "../Common/JobSystem.h"
+#include <atomic>
+#include <functional>
+#include <new>
+#include <stddef.h>
+#include <string.h>
+#include <type_traits>
+#include <vector>
+
+// Type-erased interface the bus uses to deliver/reset a queue
+class MessageQueueBase {
+public:
+    virtual ~MessageQueueBase() {}
+    // Calls the handlers for every message not delivered yet (including ones
+    // they post themselves); returns how many were delivered
+    virtual size_t Deliver() = 0;
+    // Forgets the delivered messages (the blocks are kept)
+    virtual void Reset() = 0;
+    // One staging buffer per JobSystem thread
+    virtual void SetThreadCount(int threadCount) = 0;
+    // Messages that didn't fit (past kMaxBlocks * kBlockSize in one frame)
+    virtual size_t GetDropped() const = 0;
+};
+
+// Messages of one type, stored back to back in fixed-size blocks. Posting
+// claims slots with one atomic add, so any number of threads can post at once
+// without locks; the thread that first reaches a new block allocates it and
+// publishes it with a compare-exchange. Blocks are kept between frames, so
+// once a frame's peak has been seen, posting never allocates.
+// Single messages are first gathered in the posting thread's staging buffer
+// (by JobSystem thread index) and claimed kStagingSize at a time, which keeps
+// the atomic add off the per-message path.
+template <typename T>
+class MessageQueue : public MessageQueueBase {
+public:
+    static const int kBlockShift = 12;
+    static const size_t kBlockSize = size_t(1) << kBlockShift;
+    static const int kMaxBlocks = 1024;
+    static const int kStagingSize = 64;
+
+    MessageQueue(int threadCount) : mStaging(threadCount), mCount(0), mDelivered(0), mDropped(0) {
+        for (int i = 0; i < kMaxBlocks; i++) {
+            mBlocks[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~MessageQueue() {
+        for (int i = 0; i < kMaxBlocks; i++) {
+            ::operator delete(mBlocks[i].load(std::memory_order_relaxed));
+        }
+    }
+
+    void Subscribe(std::function<void(const T&)> handler) { mHandlers.push_back(std::move(handler)); }
+    void SubscribeBatch(std::function<void(const T*, size_t)> handler) { mBatchHandlers.push_back(std::move(handler)); }
+
+    void Post(const T& message) {
+        int thread = JobSystem::GetThreadIndex();
+        if (thread < static_cast<int>(mStaging.size())) {
+            Staging& staging = mStaging[thread];
+            new (staging.Get(staging.count++)) T(message);
+            if (staging.count == kStagingSize) {
+                staging.count = 0;
+                Claim(staging.Get(0), kStagingSize);
+            }
+            return;
+        }
+        // a thread without a staging buffer claims its slot directly
+        size_t index = mCount.fetch_add(1, std::memory_order_relaxed);
+        if (index >= kMaxBlocks * kBlockSize) {
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        new (GetBlock(index >> kBlockShift) + (index & (kBlockSize - 1))) T(message);
+    }
+
+    // Claims count slots with a single atomic add (after the calling thread's
+    // staged singles, so its messages stay in the order they were posted)
+    void Post(const T* messages, size_t count) {
+        int thread = JobSystem::GetThreadIndex();
+        if (thread < static_cast<int>(mStaging.size()) && mStaging[thread].count > 0) {
+            Staging& staging = mStaging[thread];
+            int staged = staging.count;
+            staging.count = 0;
+            Claim(staging.Get(0), staged);
+        }
+        Claim(messages, count);
+    }
+
+    size_t Deliver() override {
+        size_t first = mDelivered;
+        // handlers may post more of this type, so re-check the count
+        for (;;) {
+            // workers are idle: their staged messages can be claimed from here
+            for (Staging& staging : mStaging) {
+                if (staging.count > 0) {
+                    Claim(staging.Get(0), staging.count);
+                    staging.count = 0;
+                }
+            }
+            size_t count = mCount.load(std::memory_order_acquire);
+            if (count > kMaxBlocks * kBlockSize) {
+                count = kMaxBlocks * kBlockSize;
+            }
+            if (mDelivered >= count) {
+                break;
+            }
+            // block by block: batch handlers see each run in one call
+            while (mDelivered < count) {
+                const T* block = mBlocks[mDelivered >> kBlockShift].load(std::memory_order_relaxed);
+                size_t offset = mDelivered & (kBlockSize - 1);
+                size_t run = kBlockSize - offset < count - mDelivered ? kBlockSize - offset : count - mDelivered;
+                for (const std::function<void(const T*, size_t)>& handler : mBatchHandlers) {
+                    handler(block + offset, run);
+                }
+                for (const std::function<void(const T&)>& handler : mHandlers) {
+                    for (size_t i = offset; i < offset + run; i++) {
+                        handler(block[i]);
+                    }
+                }
+                mDelivered += run;
+            }
+        }
+        return mDelivered - first;
+    }
+
+    void Reset() override {
+        mCount.store(0, std::memory_order_relaxed);
+        mDelivered = 0;
+    }
+
+    void SetThreadCount(int threadCount) override { mStaging.resize(threadCount); }
+
+    size_t GetDropped() const override { return mDropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Staging {
+        alignas(T) unsigned char storage[kStagingSize * sizeof(T)];
+        int count = 0;
+        // keep threads' buffers on separate cache lines
+        char padding[64];
+        T* Get(int index) { return reinterpret_cast<T*>(storage) + index; }
+    };
+
+    // Claims count slots with a single atomic add and copies the messages in
+    void Claim(const T* messages, size_t count) {
+        size_t index = mCount.fetch_add(count, std::memory_order_relaxed);
+        size_t end = index + count;
+        if (end > kMaxBlocks * kBlockSize) {
+            size_t capacity = index < kMaxBlocks * kBlockSize ? kMaxBlocks * kBlockSize : index;
+            mDropped.fetch_add(end - capacity, std::memory_order_relaxed);
+            end = capacity;
+        }
+        // the range may straddle blocks
+        while (index < end) {
+            size_t offset = index & (kBlockSize - 1);
+            size_t run = kBlockSize - offset < end - index ? kBlockSize - offset : end - index;
+            memcpy(static_cast<void*>(GetBlock(index >> kBlockShift) + offset), messages, run * sizeof(T));
+            messages += run;
+            index += run;
+        }
+    }
+
+    T* GetBlock(size_t block) {
+        T* storage = mBlocks[block].load(std::memory_order_acquire);
+        if (!storage) {
+            // several threads may get here for the same block: one wins
+            T* fresh = static_cast<T*>(::operator new(kBlockSize * sizeof(T)));
+            if (mBlocks[block].compare_exchange_strong(storage, fresh, std::memory_order_acq_rel,
+                                                       std::memory_order_acquire)) {
+                storage = fresh;
+            } else {
+                ::operator delete(fresh);
+            }
+        }
+        return storage;
+    }
+
+    std::vector<Staging> mStaging;
+    std::atomic<T*> mBlocks[kMaxBlocks];
+    // slots claimed this frame (may pass the capacity; those are dropped)
+    std::atomic<size_t> mCount;
+    size_t mDelivered;
+    std::atomic<size_t> mDropped;
+    std::vector<std::function<void(const T&)>> mHandlers;
+    std::vector<std::function<void(const T*, size_t)>> mBatchHandlers;
+};
+
+// Typed messages between actors and components, delivered in one batched
+// phase instead of calling into each other in the middle of the update.
+// Post appends to the message type's queue (lock-free, from any thread,
+// including pooled component phases); Dispatch, after the actor update, runs
+// every queue's handlers on the main thread, type by type in the order the
+// types were first subscribed to. Messages are plain structs (trivially
+// copyable) and never allocate per message.
+// Within a type, messages posted from one thread are delivered in the order
+// they were posted; messages from parallel work items interleave in whatever
+// order the threads got there, so use CommandBuffers when order matters.
+// Posting threads are the main thread and the workers of one JobSystem (their
+// thread index picks the staging buffer; see SetThreadCount).
+class MessageBus {
+public:
+    MessageBus() : mThreadCount(1), mDispatched(0) {}
+    ~MessageBus();
+    MessageBus(const MessageBus&) = delete;
+    MessageBus& operator=(const MessageBus&) = delete;
+
+    // Main thread, outside the update. Messages of a type nobody subscribed
+    // to are dropped by Post right away.
+    template <typename T>
+    void Subscribe(std::function<void(const T&)> handler) {
+        GetQueue<T>()->Subscribe(std::move(handler));
+    }
+    // The handler gets the queued messages a run at a time (a tight loop over
+    // them instead of a call per message); batch handlers of a type run
+    // before its per-message ones
+    template <typename T>
+    void SubscribeBatch(std::function<void(const T*, size_t)> handler) {
+        GetQueue<T>()->SubscribeBatch(std::move(handler));
+    }
+
+    template <typename T>
+    void Post(const T& message) {
+        int typeId = TypeId<T>();
+        if (typeId < static_cast<int>(mQueues.size()) && mQueues[typeId]) {
+            static_cast<MessageQueue<T>*>(mQueues[typeId])->Post(message);
+        }
+    }
+    // Posts count messages for the cost of one (e.g. collected by a work item)
+    template <typename T>
+    void Post(const T* messages, size_t count) {
+        int typeId = TypeId<T>();
+        if (typeId < static_cast<int>(mQueues.size()) && mQueues[typeId]) {
+            static_cast<MessageQueue<T>*>(mQueues[typeId])->Post(messages, count);
+        }
+    }
+
+    // One staging buffer per thread of the JobSystem that posts (main thread
+    // only, outside the update)
+    void SetThreadCount(int threadCount);
+
+    // Delivers everything posted since the last Dispatch, then empties the
+    // queues. Messages posted by handlers are delivered in the same Dispatch
+    // (a handler that always posts again never returns).
+    // Main thread, while no other thread posts.
+    void Dispatch();
+    // Messages delivered by the last Dispatch
+    size_t GetDispatchedCount() const { return mDispatched; }
+    // Messages lost to full queues so far
+    size_t GetDroppedCount() const;
+
+private:
+    template <typename T>
+    MessageQueue<T>* GetQueue() {
+        static_assert(std::is_trivially_copyable<T>::value, "messages must be trivially copyable");
+        int typeId = TypeId<T>();
+        if (typeId >= static_cast<int>(mQueues.size())) {
+            mQueues.resize(typeId + 1, nullptr);
+        }
+        if (!mQueues[typeId]) {
+            mQueues[typeId] = new MessageQueue<T>(mThreadCount);
+            mOrder.push_back(mQueues[typeId]);
+        }
+        return static_cast<MessageQueue<T>*>(mQueues[typeId]);
+    }
+
+    template <typename T>
+    static int TypeId() {
+        // posting threads may be first to see a type
+        static const int id = sNextTypeId.fetch_add(1);
+        return id;
+    }
+
+    static std::atomic<int> sNextTypeId;
+    // by type id (nullptr: nobody subscribed)
+    std::vector<MessageQueueBase*> mQueues;
+    // in the order the types were first subscribed to
+    std::vector<MessageQueueBase*> mOrder;
+    int mThreadCount;
+    size_t mDispatched;
+};
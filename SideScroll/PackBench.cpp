@@ -0,0 +1,112 @@
+#include "AssetPack.h"
+#include "BenchImages.h"
+#include "SDL/SDL_image.h"
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Startup time to get a level's textures onto SDL's software renderer from
+// loose PNGs (IMG_Load + SDL_CreateTextureFromSurface, the old GetTexture)
+// vs. a memory-mapped pack, with the OS file cache cold and warm.
+// The PNGs and the pack are generated first into the directory given as argument.
+const int benchImages = 64;
+const int benchImageSize = 512;
+
+// Asks the OS to drop the file from its page cache (POSIX only; on Windows
+// the "cold" numbers are really warm)
+void DropFromCache(const std::string& fileName) {
+#ifndef _WIN32
+    int file = open(fileName.c_str(), O_RDONLY);
+    if (file >= 0) {
+        fdatasync(file);
+        posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+        close(file);
+    }
+#endif
+}
+
+double LoadLoose(SDL_Renderer* renderer, const std::vector<std::string>& files) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<SDL_Texture*> textures;
+    for (const std::string& file : files) {
+        SDL_Surface* surf = IMG_Load(file.c_str());
+        textures.push_back(surf ? SDL_CreateTextureFromSurface(renderer, surf) : nullptr);
+        SDL_FreeSurface(surf);
+    }
+    double ms = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1000.0;
+    for (SDL_Texture* text : textures) {
+        SDL_DestroyTexture(text);
+    }
+    return ms;
+}
+
+double LoadPack(SDL_Renderer* renderer, const std::string& packName, const std::vector<std::string>& files) {
+    auto start = std::chrono::steady_clock::now();
+    AssetPack pack;
+    std::vector<SDL_Texture*> textures;
+    if (pack.Open(packName.c_str())) {
+        for (const std::string& file : files) {
+            const PackEntry* entry = pack.Find(HashAssetName(file.c_str()));
+            textures.push_back(entry ? pack.CreateTexture(renderer, *entry) : nullptr);
+        }
+    }
+    double ms = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1000.0;
+    for (SDL_Texture* text : textures) {
+        SDL_DestroyTexture(text);
+    }
+    return ms;
+}
+
+int main(int argc, char** argv) {
+    std::string dir = argc > 1 ? argv[1] : ".";
+    if (IMG_Init(IMG_INIT_PNG) == 0) {
+        SDL_Log("Unable to initialize SDL_image: %s", SDL_GetError());
+        return 1;
+    }
+
+    // noisy images so the PNG decode does real work
+    std::vector<std::string> files;
+    if (!WriteNoisePngs(dir, "pack_bench", benchImages, benchImageSize, files)) {
+        return 1;
+    }
+    std::string packName = dir + "/pack_bench.pack";
+    if (!AssetPack::Write(packName.c_str(), files)) {
+        return 1;
+    }
+
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, 1024, 700, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    if (!renderer) {
+        SDL_Log("Failed to create software renderer: %s", SDL_GetError());
+        return 1;
+    }
+
+    for (const std::string& file : files) {
+        DropFromCache(file);
+    }
+    double looseCold = LoadLoose(renderer, files);
+    double looseWarm = LoadLoose(renderer, files);
+    DropFromCache(packName);
+    double packCold = LoadPack(renderer, packName, files);
+    double packWarm = LoadPack(renderer, packName, files);
+
+    printf("%d images of %dx%d\n", benchImages, benchImageSize, benchImageSize);
+    printf("%-12s %12s %12s\n", "source", "cold ms", "warm ms");
+    printf("%-12s %12.1f %12.1f\n", "loose PNG", looseCold, looseWarm);
+    printf("%-12s %12.1f %12.1f (%.1fx / %.1fx)\n", "pack", packCold, packWarm, looseCold / packCold,
+           looseWarm / packWarm);
+
+    for (const std::string& file : files) {
+        remove(file.c_str());
+    }
+    remove(packName.c_str());
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    IMG_Quit();
+    return 0;
+}
@@ -0,0 +1,20 @@
+#include "AssetPack.h"
+#include "SDL/SDL_image.h"
+
+// Packer: pack_tool <out.pack> <image>...
+// Images are looked up at runtime by the name given here (e.g. "Assets/Ship.png").
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        printf("usage: %s <out.pack> <image>...\n", argv[0]);
+        return 1;
+    }
+    if (IMG_Init(IMG_INIT_PNG) == 0) {
+        SDL_Log("Unable to initialize SDL_image: %s", SDL_GetError());
+        return 1;
+    }
+    std::vector<std::string> fileNames(argv + 2, argv + argc);
+    bool ok = AssetPack::Write(argv[1], fileNames);
+    printf("%s %s with %d image(s)\n", ok ? "wrote" : "failed to write", argv[1], argc - 2);
+    IMG_Quit();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+#include "SpriteBatcher.h"
+#include "../Common/TiledRasterizer.h"
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <cmath>
+
+SpriteBatcher::SpriteBatcher() {
+    mImmediate = false;
+    mStats = {};
+}
+
+void SpriteBatcher::AddSprite(SDL_Texture* texture, int texWidth, int texHeight, const SDL_Rect& src,
+                              const SDL_Rect& dst, float rotation, int drawOrder) {
+    AddSprite(texture, texWidth, texHeight, src, dst, rotation, cosf(rotation), sinf(rotation), drawOrder);
+}
+
+void SpriteBatcher::AddSprite(SDL_Texture* texture, int texWidth, int texHeight, const SDL_Rect& src,
+                              const SDL_Rect& dst, float rotation, float cosine, float sine, int drawOrder) {
+    mQuads.push_back({texture, texWidth, texHeight, src, dst, rotation, cosine, sine, drawOrder});
+}
+
+void SpriteBatcher::SortQuads() {
+    auto byDrawOrder = [](const Quad& a, const Quad& b) { return a.drawOrder < b.drawOrder; };
+    if (!std::is_sorted(mQuads.begin(), mQuads.end(), byDrawOrder)) {
+        std::stable_sort(mQuads.begin(), mQuads.end(), byDrawOrder);
+    }
+}
+
+void SpriteBatcher::AppendVertices(const Quad& quad) {
+    float halfW = quad.dst.w * 0.5f;
+    float halfH = quad.dst.h * 0.5f;
+    float centerX = quad.dst.x + halfW;
+    float centerY = quad.dst.y + halfH;
+    // counterclockwise on screen is a negative angle with y pointing down
+    float c = quad.cosine;
+    float s = -quad.sine;
+    float u0 = static_cast<float>(quad.src.x) / quad.texWidth;
+    float v0 = static_cast<float>(quad.src.y) / quad.texHeight;
+    float u1 = static_cast<float>(quad.src.x + quad.src.w) / quad.texWidth;
+    float v1 = static_cast<float>(quad.src.y + quad.src.h) / quad.texHeight;
+
+    // top left, top right, bottom right, bottom left
+    const float cornerX[4] = {-halfW, halfW, halfW, -halfW};
+    const float cornerY[4] = {-halfH, -halfH, halfH, halfH};
+    const float cornerU[4] = {u0, u1, u1, u0};
+    const float cornerV[4] = {v0, v0, v1, v1};
+    for (int i = 0; i < 4; i++) {
+        SDL_Vertex vertex;
+        vertex.position.x = centerX + cornerX[i] * c - cornerY[i] * s;
+        vertex.position.y = centerY + cornerX[i] * s + cornerY[i] * c;
+        vertex.color = {255, 255, 255, 255};
+        vertex.tex_coord.x = cornerU[i];
+        vertex.tex_coord.y = cornerV[i];
+        mVertices.push_back(vertex);
+    }
+}
+
+void SpriteBatcher::Flush(SDL_Renderer* renderer) {
+    SortQuads();
+    int numQuads = static_cast<int>(mQuads.size());
+    mStats.sprites = numQuads;
+    mStats.drawCalls = 0;
+    mStats.textureSwitches = 0;
+    mStats.skipped = 0;
+
+    SDL_Texture* lastTexture = nullptr;
+    if (mImmediate) {
+        // one copy per sprite, like SpriteComponent::Draw used to do
+        for (const Quad& quad : mQuads) {
+            if (quad.texture != lastTexture) {
+                mStats.textureSwitches++;
+                lastTexture = quad.texture;
+            }
+            SDL_RenderCopyEx(renderer, quad.texture, &quad.src, &quad.dst, -quad.rotation * 180.0f / 3.14159265f,
+                             nullptr, SDL_FLIP_NONE);
+            mStats.drawCalls++;
+        }
+    } else {
+        int start = 0;
+        while (start < numQuads) {
+            // extend the run while the texture stays the same
+            SDL_Texture* texture = mQuads[start].texture;
+            int end = start + 1;
+            while (end < numQuads && mQuads[end].texture == texture) {
+                end++;
+            }
+            int runQuads = end - start;
+
+            mVertices.clear();
+            for (int i = start; i < end; i++) {
+                AppendVertices(mQuads[i]);
+            }
+            // grow the shared index pattern if this run is the longest yet
+            for (int quad = static_cast<int>(mIndices.size()) / 6; quad < runQuads; quad++) {
+                int base = quad * 4;
+                const int pattern[6] = {base, base + 1, base + 2, base, base + 2, base + 3};
+                mIndices.insert(mIndices.end(), pattern, pattern + 6);
+            }
+            SDL_RenderGeometry(renderer, texture, mVertices.data(), runQuads * 4, mIndices.data(), runQuads * 6);
+            mStats.drawCalls++;
+            mStats.textureSwitches++;
+            start = end;
+        }
+    }
+
+    mQuads.clear();
+}
+
+void SpriteBatcher::Flush(TiledRasterizer& rasterizer, const TextureAtlas& atlas) {
+    SortQuads();
+    mStats.sprites = static_cast<int>(mQuads.size());
+    mStats.drawCalls = 0;
+    mStats.textureSwitches = 0;
+    mStats.skipped = 0;
+
+    SDL_Texture* lastTexture = nullptr;
+    const RasterImage* image = nullptr;
+    for (const Quad& quad : mQuads) {
+        if (quad.texture != lastTexture) {
+            mStats.textureSwitches++;
+            lastTexture = quad.texture;
+            image = atlas.FindPageImage(quad.texture);
+        }
+        if (!image) {
+            mStats.skipped++;
+            continue;
+        }
+        RasterRect src = {quad.src.x, quad.src.y, quad.src.w, quad.src.h};
+        RasterRect dst = {quad.dst.x, quad.dst.y, quad.dst.w, quad.dst.h};
+        rasterizer.Blit(*image, src, dst, true);
+        mStats.drawCalls++;
+    }
+    mQuads.clear();
+}
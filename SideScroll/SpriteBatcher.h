@@ -0,0 +1,73 @@
+#pragma once
+#include "SDL/SDL.h"
+#include <vector>
+
+class TextureAtlas;
+class TiledRasterizer;
+
+// Draw counts for the last flushed frame
+struct SpriteBatchStats {
+    int sprites;         // sprites submitted
+    int drawCalls;       // SDL_RenderCopyEx/SDL_RenderGeometry calls issued
+    int textureSwitches; // times the texture differed from the previous draw
+    int skipped;         // sprites a rasterizer flush couldn't draw (texture isn't a kept atlas page)
+};
+
+// Collects the textured quads of a frame and draws each run of consecutive
+// sprites that share a texture (an atlas page) with one SDL_RenderGeometry
+// call. Sprites are drawn by draw order, and in submission order within one
+// (the draw list submits them sorted, so nothing is moved then). Rotation is
+// applied to the quad corners on the CPU.
+// The quad, vertex and index arrays only ever grow, so once the busiest frame
+// has been seen, adding and flushing sprites doesn't allocate.
+class SpriteBatcher {
+public:
+    SpriteBatcher();
+    // Immediate mode issues one SDL_RenderCopyEx per sprite (the unbatched baseline)
+    void SetImmediate(bool immediate) { mImmediate = immediate; }
+    bool IsImmediate() const { return mImmediate; }
+
+    // src is in pixels of a texWidth x texHeight texture; dst is in screen
+    // pixels; rotation is counterclockwise in radians around dst's center
+    void AddSprite(SDL_Texture* texture, int texWidth, int texHeight, const SDL_Rect& src, const SDL_Rect& dst,
+                   float rotation, int drawOrder = 0);
+    // Same, with the rotation's cosine/sine already known (e.g. cached by the
+    // TransformSystem), so no trig is done per sprite
+    void AddSprite(SDL_Texture* texture, int texWidth, int texHeight, const SDL_Rect& src, const SDL_Rect& dst,
+                   float rotation, float cosine, float sine, int drawOrder = 0);
+    // Sprites added since the last flush or clear
+    int GetSpriteCount() const { return static_cast<int>(mQuads.size()); }
+    // Forgets the sprites added so far (keeping the capacity); Flush does
+    // this after drawing, a batcher that is reused without a flush needs it
+    void Clear() { mQuads.clear(); }
+    // Draws everything added since the last flush
+    void Flush(SDL_Renderer* renderer);
+    // Same order, recorded into a software rasterizer as one blended blit per
+    // sprite. The textures must be pages of an atlas built with SetKeepPixels;
+    // rotation is ignored (the rasterizer only blits axis-aligned rects).
+    void Flush(TiledRasterizer& rasterizer, const TextureAtlas& atlas);
+    const SpriteBatchStats& GetStats() const { return mStats; }
+
+private:
+    struct Quad {
+        SDL_Texture* texture;
+        int texWidth;
+        int texHeight;
+        SDL_Rect src;
+        SDL_Rect dst;
+        float rotation;
+        float cosine;
+        float sine;
+        int drawOrder;
+    };
+    void AppendVertices(const Quad& quad);
+    // Stable sort by draw order (only if something was added out of order)
+    void SortQuads();
+
+    std::vector<Quad> mQuads;
+    // vertices of the run being drawn, and 6 indices per quad (shared by every run)
+    std::vector<SDL_Vertex> mVertices;
+    std::vector<int> mIndices;
+    bool mImmediate;
+    SpriteBatchStats mStats;
+};
@@ -0,0 +1,137 @@
+#include "../Common/JobSystem.h"
+#include "../Common/TiledRasterizer.h"
+#include "SpriteBatcher.h"
+#include "TextureAtlas.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+// Draws 10k sprites picked from 16 images on SDL's software renderer (no
+// window/GPU needed), with one texture per image vs. the images packed into an
+// atlas, each both immediate (one copy per sprite) and batched. The atlas
+// sprites are also drawn by the tiled software rasterizer on 1 and 4 threads
+// (unrotated, so its numbers aren't the same work as the renderer's).
+const int benchSprites = 10000;
+const int benchImages = 16;
+const int benchFrames = 60;
+
+SDL_Surface* MakeImage(int index) {
+    SDL_Surface* surf = SDL_CreateRGBSurfaceWithFormat(0, 24 + index, 24 + (index * 7) % 16, 32,
+                                                       SDL_PIXELFORMAT_ARGB8888);
+    if (surf) {
+        SDL_FillRect(surf, nullptr, SDL_MapRGBA(surf->format, 40 * index, 255 - 12 * index, 90, 255));
+    }
+    return surf;
+}
+
+int main(int argc, char** argv) {
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, 1024, 700, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!target) {
+        SDL_Log("Failed to create surface: %s", SDL_GetError());
+        return 1;
+    }
+    SDL_Renderer* renderer = SDL_CreateSoftwareRenderer(target);
+    if (!renderer) {
+        SDL_Log("Failed to create software renderer: %s", SDL_GetError());
+        return 1;
+    }
+
+    // one texture per image, and the same images in an atlas
+    SDL_Texture* textures[benchImages];
+    int widths[benchImages];
+    int heights[benchImages];
+    TextureAtlas atlas(256);
+    atlas.SetKeepPixels(true);
+    for (int i = 0; i < benchImages; i++) {
+        SDL_Surface* surf = MakeImage(i);
+        if (!surf) {
+            SDL_Log("Failed to create image: %s", SDL_GetError());
+            return 1;
+        }
+        textures[i] = SDL_CreateTextureFromSurface(renderer, surf);
+        widths[i] = surf->w;
+        heights[i] = surf->h;
+        atlas.AddImage(std::to_string(i), surf);
+    }
+    if (!atlas.Build(renderer)) {
+        return 1;
+    }
+
+    // sprites in draw order, images interleaved like a real level
+    srand(42);
+    struct Sprite {
+        int image;
+        SDL_Rect dst;
+        float rotation;
+    };
+    Sprite* sprites = new Sprite[benchSprites];
+    for (int i = 0; i < benchSprites; i++) {
+        int image = rand() % benchImages;
+        sprites[i] = {image, {rand() % 1000, rand() % 680, widths[image], heights[image]}, (rand() % 628) / 100.0f};
+    }
+
+    printf("%d sprites, %d images, %d atlas page(s)\n", benchSprites, benchImages, atlas.GetPageCount());
+    printf("%10s %10s %12s %12s %16s\n", "textures", "mode", "ms/frame", "draw calls", "texture switches");
+    SpriteBatcher batcher;
+    for (int useAtlas = 0; useAtlas < 2; useAtlas++) {
+        for (int batched = 0; batched < 2; batched++) {
+            batcher.SetImmediate(!batched);
+            auto start = std::chrono::steady_clock::now();
+            for (int frame = 0; frame < benchFrames; frame++) {
+                SDL_RenderClear(renderer);
+                for (int i = 0; i < benchSprites; i++) {
+                    const Sprite& sprite = sprites[i];
+                    if (useAtlas) {
+                        const AtlasRegion* region = atlas.Find(std::to_string(sprite.image));
+                        batcher.AddSprite(region->texture, region->pageWidth, region->pageHeight, region->rect,
+                                          sprite.dst, sprite.rotation);
+                    } else {
+                        SDL_Rect src = {0, 0, widths[sprite.image], heights[sprite.image]};
+                        batcher.AddSprite(textures[sprite.image], src.w, src.h, src, sprite.dst, sprite.rotation);
+                    }
+                }
+                batcher.Flush(renderer);
+                SDL_RenderPresent(renderer);
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            const SpriteBatchStats& stats = batcher.GetStats();
+            printf("%10s %10s %12.3f %12d %16d\n", useAtlas ? "atlas" : "separate", batched ? "batched" : "immediate",
+                   seconds * 1000.0 / benchFrames, stats.drawCalls, stats.textureSwitches);
+        }
+    }
+
+    TiledRasterizer rasterizer;
+    rasterizer.Resize(1024, 700);
+    const int threadCounts[] = {1, 4};
+    for (int threads : threadCounts) {
+        JobSystem jobs(threads);
+        rasterizer.SetJobSystem(threads > 1 ? &jobs : nullptr);
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < benchFrames; frame++) {
+            rasterizer.Clear(0xFF000000);
+            for (int i = 0; i < benchSprites; i++) {
+                const Sprite& sprite = sprites[i];
+                const AtlasRegion* region = atlas.Find(std::to_string(sprite.image));
+                batcher.AddSprite(region->texture, region->pageWidth, region->pageHeight, region->rect, sprite.dst,
+                                  sprite.rotation);
+            }
+            batcher.Flush(rasterizer, atlas);
+            rasterizer.Execute();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const SpriteBatchStats& stats = batcher.GetStats();
+        std::string mode = "raster " + std::to_string(threads) + "t";
+        printf("%10s %10s %12.3f %12d %16d\n", "atlas", mode.c_str(), seconds * 1000.0 / benchFrames, stats.drawCalls,
+               stats.textureSwitches);
+    }
+
+    delete[] sprites;
+    atlas.Clear();
+    for (int i = 0; i < benchImages; i++) {
+        SDL_DestroyTexture(textures[i]);
+    }
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    return 0;
+}
@@ -1,7 +1,117 @@
 #include "SpriteComponent.h"
+#include "Actor.h"
+#include "Game.h"
+
+SpriteComponent::SpriteComponent(Actor* owner, int drawOrder) : Component(owner) {
+    mTexture = nullptr;
+    mDrawOrder = drawOrder;
+    mTexWidth = 0;
+    mTexHeight = 0;
+    mSrcRect = {0, 0, 0, 0};
+    mSheetWidth = 0;
+    mSheetHeight = 0;
+    mDrawListIndex = -1;
+    mAnimationIndex = -1;
+    mOwner->GetGame()->AddSprite(this);
+}
+
+SpriteComponent::~SpriteComponent() {
+    if (mAnimationIndex >= 0) {
+        mOwner->GetGame()->GetAnimations().Stop(this);
+    }
+    mOwner->GetGame()->RemoveSprite(this);
+}
+
+void SpriteComponent::Draw(SpriteBatcher& batcher) {
+    if (mTexture) {
+        // Scale the texture and center it on the owner's world position,
+        // relative to the camera (the rotation's cosine/sine are cached)
+        const Vector2& camera = mOwner->GetGame()->GetCameraPosition();
+        Vector2 position = mOwner->GetWorldPosition();
+        float scale = mOwner->GetWorldScale();
+        SDL_Rect r;
+        r.w = static_cast<int>(mTexWidth * scale);
+        r.h = static_cast<int>(mTexHeight * scale);
+        r.x = static_cast<int>(position.x - camera.x - r.w / 2);
+        r.y = static_cast<int>(position.y - camera.y - r.h / 2);
+        batcher.AddSprite(mTexture, mSheetWidth, mSheetHeight, mSrcRect, r, mOwner->GetWorldRotation(),
+                          mOwner->GetWorldCosine(), mOwner->GetWorldSine(), mDrawOrder);
+    }
+}
 
 void SpriteComponent::SetTexture(SDL_Texture* texture) {
+    mTextureHandle.Reset();
     mTexture = texture;
     // Get width/height of texture
     SDL_QueryTexture(texture, nullptr, nullptr, &mTexWidth, &mTexHeight);
-}
\ No newline at end of file
+    mSrcRect = {0, 0, mTexWidth, mTexHeight};
+    mSheetWidth = mTexWidth;
+    mSheetHeight = mTexHeight;
+}
+
+void SpriteComponent::SetTexture(const TextureHandle& texture) {
+    // copy first: texture may be our own handle
+    TextureHandle handle = texture;
+    // the asset has the size, so the texture isn't queried (the update may
+    // not be on the renderer's thread)
+    mTexture = handle->texture;
+    mTexWidth = handle->width;
+    mTexHeight = handle->height;
+    mSrcRect = {0, 0, mTexWidth, mTexHeight};
+    mSheetWidth = mTexWidth;
+    mSheetHeight = mTexHeight;
+    mTextureHandle = handle;
+}
+
+void SpriteComponent::SyncTexture() {
+    if (mTextureHandle && mTextureHandle->texture != mTexture) {
+        SetTexture(mTextureHandle);
+    }
+}
+
+void SpriteComponent::SetAtlasRegion(const AtlasRegion& region) {
+    mTextureHandle.Reset();
+    mTexture = region.texture;
+    mTexWidth = region.rect.w;
+    mTexHeight = region.rect.h;
+    mSrcRect = region.rect;
+    mSheetWidth = region.pageWidth;
+    mSheetHeight = region.pageHeight;
+}
+
+void SpriteComponent::SetSheetFrame(SDL_Texture* texture, int sheetWidth, int sheetHeight, const SDL_Rect& frame) {
+    if (mTextureHandle) {
+        mTextureHandle.Reset();
+    }
+    mTexture = texture;
+    mSheetWidth = sheetWidth;
+    mSheetHeight = sheetHeight;
+    SetFrameRect(frame);
+}
+
+void SpriteComponent::SetDrawOrder(int drawOrder) {
+    if (drawOrder == mDrawOrder) {
+        return;
+    }
+    int oldDrawOrder = mDrawOrder;
+    mDrawOrder = drawOrder;
+    mOwner->GetGame()->ReorderSprite(this, oldDrawOrder);
+}
+
+SDL_Rect SpriteComponent::GetBounds() const {
+    float width = mTexWidth * mOwner->GetWorldScale();
+    float height = mTexHeight * mOwner->GetWorldScale();
+    if (mOwner->GetWorldSine() != 0.0f) {
+        // any rotation fits in the square around the diagonal
+        float diagonal = SDL_sqrtf(width * width + height * height);
+        width = diagonal;
+        height = diagonal;
+    }
+    Vector2 position = mOwner->GetWorldPosition();
+    SDL_Rect bounds;
+    bounds.x = static_cast<int>(position.x - width / 2) - 1;
+    bounds.y = static_cast<int>(position.y - height / 2) - 1;
+    bounds.w = static_cast<int>(width) + 2;
+    bounds.h = static_cast<int>(height) + 2;
+    return bounds;
+}
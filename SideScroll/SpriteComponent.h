@@ -1,24 +1,62 @@
 #pragma once
 #include "Component.h"
 #include "SDL/SDL.h"
+#include "SpriteBatcher.h"
+#include "TextureAtlas.h"
+#include "TextureLoader.h"
 
 class SpriteComponent : public Component {
 public:
     // (Lower draw order corresponds with further back)
     SpriteComponent(class Actor* owner, int drawOrder = 100);
     ~SpriteComponent();
-    virtual void Draw(SDL_Renderer* renderer);
+    // Queues the sprite's quad (drawn when the batcher is flushed)
+    virtual void Draw(SpriteBatcher& batcher);
+    // Draws the whole texture
     virtual void SetTexture(SDL_Texture* texture);
+    // Draws a streamed texture (its placeholder until it has loaded)
+    virtual void SetTexture(const TextureHandle& texture);
+    // Picks up a streamed texture that finished loading (DrawList calls it per frame)
+    void SyncTexture();
+    // Draws one image packed in an atlas page
+    virtual void SetAtlasRegion(const AtlasRegion& region);
+    // Draws the frame rect of a sheetWidth x sheetHeight texture (no texture query)
+    void SetSheetFrame(SDL_Texture* texture, int sheetWidth, int sheetHeight, const SDL_Rect& frame);
+    // Shows another frame of the same sheet (called by the AnimationSystem)
+    void SetFrameRect(const SDL_Rect& frame) {
+        mSrcRect = frame;
+        mTexWidth = frame.w;
+        mTexHeight = frame.h;
+    }
     int GetDrawOrder() const { return mDrawOrder; }
+    // Moves the sprite to its new place in the game's draw list
+    void SetDrawOrder(int drawOrder);
     int GetTexHeight() const { return mTexHeight; }
     int GetTexWidth() const { return mTexWidth; }
+    // World-space rectangle the sprite can cover (conservative when rotated)
+    SDL_Rect GetBounds() const;
+
+    // Position in the draw list's bucket (maintained by DrawList)
+    int GetDrawListIndex() const { return mDrawListIndex; }
+    void SetDrawListIndex(int index) { mDrawListIndex = index; }
+    // Row in the AnimationSystem (-1 if not animated, maintained by it)
+    int GetAnimationIndex() const { return mAnimationIndex; }
+    void SetAnimationIndex(int index) { mAnimationIndex = index; }
 
 protected:
     // Texture to draw
     SDL_Texture* mTexture;
     // Draw order used for painter's algorithm
     int mDrawOrder;
-    // Width/height of texture
+    // Width/height of texture (of the image, for an atlas region)
     int mTexWidth;
     int mTexHeight;
-};
\ No newline at end of file
+    // Part of mTexture drawn and the size of the whole texture
+    SDL_Rect mSrcRect;
+    int mSheetWidth;
+    int mSheetHeight;
+    int mDrawListIndex;
+    int mAnimationIndex;
+    // Streamed texture this sprite follows (empty for a plain texture/atlas region)
+    TextureHandle mTextureHandle;
+};
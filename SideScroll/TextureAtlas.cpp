@@ -0,0 +1,130 @@
+#include "TextureAtlas.h"
+#include "SDL/SDL_image.h"
+#include <algorithm>
+
+TextureAtlas::TextureAtlas(int pageSize, int padding) {
+    mPageSize = pageSize;
+    mPadding = padding;
+    mKeepPixels = false;
+}
+
+TextureAtlas::~TextureAtlas() {
+    Clear();
+}
+
+bool TextureAtlas::AddFile(const char* fileName) {
+    SDL_Surface* surf = IMG_Load(fileName);
+    if (!surf) {
+        SDL_Log("Failed to load texture file %s", fileName);
+        return false;
+    }
+    AddImage(fileName, surf);
+    return true;
+}
+
+void TextureAtlas::AddImage(const std::string& name, SDL_Surface* surface) {
+    mPending.push_back({name, surface});
+}
+
+bool TextureAtlas::Build(SDL_Renderer* renderer) {
+    // tallest first keeps shelves tight
+    std::sort(mPending.begin(), mPending.end(), [](const PendingImage& a, const PendingImage& b) {
+        return a.surface->h > b.surface->h;
+    });
+
+    bool ok = true;
+    size_t next = 0;
+    while (next < mPending.size()) {
+        // an image bigger than a page gets a page of its own size
+        int pageWidth = std::max(mPageSize, mPending[next].surface->w + 2 * mPadding);
+        int pageHeight = std::max(mPageSize, mPending[next].surface->h + 2 * mPadding);
+        SDL_Surface* page = SDL_CreateRGBSurfaceWithFormat(0, pageWidth, pageHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (!page) {
+            SDL_Log("Failed to create atlas page: %s", SDL_GetError());
+            ok = false;
+            break;
+        }
+        SDL_FillRect(page, nullptr, 0);
+
+        // place images until one doesn't fit on this page
+        std::vector<std::pair<size_t, SDL_Rect>> placed;
+        Cursor cursor = {mPadding, mPadding, 0};
+        for (; next < mPending.size(); next++) {
+            SDL_Surface* image = mPending[next].surface;
+            if (cursor.x + image->w + mPadding > pageWidth) {
+                // row is full, open a new shelf below it
+                cursor.x = mPadding;
+                cursor.y += cursor.shelfHeight + mPadding;
+                cursor.shelfHeight = 0;
+            }
+            // too wide even for an empty shelf (or too tall for what's left):
+            // it starts the next page, which is sized for it
+            if (cursor.x + image->w + mPadding > pageWidth || cursor.y + image->h + mPadding > pageHeight) {
+                break;
+            }
+            SDL_Rect rect = {cursor.x, cursor.y, image->w, image->h};
+            // copy the pixels as they are (no blending into the empty page)
+            SDL_SetSurfaceBlendMode(image, SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(image, nullptr, page, &rect);
+            placed.push_back({next, rect});
+            cursor.x += image->w + mPadding;
+            cursor.shelfHeight = std::max(cursor.shelfHeight, image->h);
+        }
+
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, page);
+        if (!texture) {
+            SDL_Log("Failed to convert atlas page to texture: %s", SDL_GetError());
+            SDL_FreeSurface(page);
+            ok = false;
+            break;
+        }
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        mPages.push_back(texture);
+        if (mKeepPixels) {
+            // ARGB8888 surface: the pitch is a whole number of pixels
+            RasterImage image = {static_cast<const uint32_t*>(page->pixels), page->w, page->h, page->pitch / 4};
+            mKeptPages.push_back({texture, page, image});
+        } else {
+            SDL_FreeSurface(page);
+        }
+        for (auto& entry : placed) {
+            mRegions[mPending[entry.first].name] = {texture, entry.second, pageWidth, pageHeight};
+        }
+    }
+
+    for (PendingImage& image : mPending) {
+        SDL_FreeSurface(image.surface);
+    }
+    mPending.clear();
+    return ok;
+}
+
+const AtlasRegion* TextureAtlas::Find(const std::string& name) const {
+    auto iter = mRegions.find(name);
+    return iter != mRegions.end() ? &iter->second : nullptr;
+}
+
+const RasterImage* TextureAtlas::FindPageImage(SDL_Texture* page) const {
+    for (const KeptPage& kept : mKeptPages) {
+        if (kept.texture == page) {
+            return &kept.image;
+        }
+    }
+    return nullptr;
+}
+
+void TextureAtlas::Clear() {
+    for (SDL_Texture* page : mPages) {
+        SDL_DestroyTexture(page);
+    }
+    mPages.clear();
+    for (KeptPage& kept : mKeptPages) {
+        SDL_FreeSurface(kept.surface);
+    }
+    mKeptPages.clear();
+    mRegions.clear();
+    for (PendingImage& image : mPending) {
+        SDL_FreeSurface(image.surface);
+    }
+    mPending.clear();
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "../Common/TiledRasterizer.h"
+#include "SDL/SDL.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Where one packed image ended up
+struct AtlasRegion {
+    SDL_Texture* texture; // atlas page
+    SDL_Rect rect;        // pixels of the image inside the page
+    int pageWidth;
+    int pageHeight;
+};
+
+// Packs many images into a few large page textures at load time, so sprites
+// from the same level share textures and can be drawn in one batch.
+// Images are sorted by height and placed on shelves (rows) left to right; a
+// new shelf opens when a row is full and a new page when the page is full.
+class TextureAtlas {
+public:
+    TextureAtlas(int pageSize = 2048, int padding = 1);
+    ~TextureAtlas();
+    // Queue an image for packing (loads the file now)
+    bool AddFile(const char* fileName);
+    // Queue an image for packing (the atlas takes ownership of the surface)
+    void AddImage(const std::string& name, SDL_Surface* surface);
+    // Keep each page's pixels in memory after Build as well, so sprites can
+    // be drawn by the TiledRasterizer (set before Build)
+    void SetKeepPixels(bool keep) { mKeepPixels = keep; }
+    // Packs every queued image and uploads the pages
+    bool Build(SDL_Renderer* renderer);
+    // nullptr if the image wasn't packed
+    const AtlasRegion* Find(const std::string& name) const;
+    int GetPageCount() const { return static_cast<int>(mPages.size()); }
+    // The pixels of the page uploaded as this texture; nullptr if they weren't
+    // kept or the texture isn't one of the pages
+    const RasterImage* FindPageImage(SDL_Texture* page) const;
+    // Destroys the pages and forgets every region
+    void Clear();
+
+private:
+    struct PendingImage {
+        std::string name;
+        SDL_Surface* surface;
+    };
+    // Shelf packer state for the page being filled
+    struct Cursor {
+        int x;
+        int y;
+        int shelfHeight;
+    };
+
+    int mPageSize;
+    int mPadding;
+    std::vector<PendingImage> mPending;
+    std::vector<SDL_Texture*> mPages;
+    bool mKeepPixels;
+    // Pages built with mKeepPixels set: the ARGB surface and a view of its pixels
+    struct KeptPage {
+        SDL_Texture* texture;
+        SDL_Surface* surface;
+        RasterImage image;
+    };
+    std::vector<KeptPage> mKeptPages;
+    std::unordered_map<std::string, AtlasRegion> mRegions;
+};
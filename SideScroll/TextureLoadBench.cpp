@@ -0,0 +1,78 @@
+#include "BenchImages.h"
+#include "SDL/SDL_image.h"
+#include "TextureLoader.h"
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// "Startup" time to get a level's textures onto SDL's software renderer:
+// decoding every PNG on the main thread (the old GetTexture) vs. the
+// TextureLoader with 1, 4 and 8 decode threads. The PNGs are generated first
+// (noise, so decoding does real work) into the directory given as argument.
+const int benchImages = 64;
+const int benchImageSize = 512;
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    std::string dir = argc > 1 ? argv[1] : ".";
+    if (IMG_Init(IMG_INIT_PNG) == 0) {
+        SDL_Log("Unable to initialize SDL_image: %s", SDL_GetError());
+        return 1;
+    }
+
+    std::vector<std::string> files;
+    if (!WriteNoisePngs(dir, "texture_bench", benchImages, benchImageSize, files)) {
+        return 1;
+    }
+
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, 1024, 700, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    if (!renderer) {
+        SDL_Log("Failed to create software renderer: %s", SDL_GetError());
+        return 1;
+    }
+
+    printf("%d PNGs of %dx%d\n", benchImages, benchImageSize, benchImageSize);
+    printf("%-22s %10s\n", "loader", "ms");
+
+    // main thread decodes and uploads each file in turn
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string& file : files) {
+        SDL_Surface* surf = IMG_Load(file.c_str());
+        SDL_Texture* text = surf ? SDL_CreateTextureFromSurface(renderer, surf) : nullptr;
+        SDL_FreeSurface(surf);
+        SDL_DestroyTexture(text);
+    }
+    double syncMs = SecondsSince(start) * 1000.0;
+    printf("%-22s %10.1f\n", "synchronous", syncMs);
+
+    const int threadCounts[] = {1, 4, 8};
+    for (int threads : threadCounts) {
+        TextureLoader loader;
+        if (!loader.Initialize(renderer, threads)) {
+            return 1;
+        }
+        start = std::chrono::steady_clock::now();
+        for (const std::string& file : files) {
+            loader.Request(file.c_str());
+        }
+        loader.Finish();
+        double ms = SecondsSince(start) * 1000.0;
+        char label[32];
+        snprintf(label, sizeof(label), "async, %d thread%s", threads, threads > 1 ? "s" : "");
+        printf("%-22s %10.1f (%.2fx)\n", label, ms, syncMs / ms);
+        loader.Shutdown();
+    }
+
+    for (const std::string& file : files) {
+        remove(file.c_str());
+    }
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    IMG_Quit();
+    return 0;
+}
@@ -0,0 +1,393 @@
+#include "TextureLoader.h"
+#include "AssetPack.h"
+#include "SDL/SDL_image.h"
+
+TextureHandle::TextureHandle(TextureAsset* asset) : mAsset(asset) {
+    if (mAsset) {
+        mAsset->refCount++;
+    }
+}
+
+TextureHandle::TextureHandle(const TextureHandle& other) : mAsset(other.mAsset) {
+    if (mAsset) {
+        mAsset->refCount++;
+    }
+}
+
+void TextureHandle::Reset() {
+    if (mAsset && --mAsset->refCount == 0) {
+        mAsset->loader->Release(mAsset);
+    }
+    mAsset = nullptr;
+}
+
+TextureLoader::TextureLoader() {
+    mRenderer = nullptr;
+    mPlaceholder = nullptr;
+    mPack = nullptr;
+    mRenderThread = false;
+    mPending = 0;
+    // generous default; a level sets its own with SetBudget
+    mBudget = 256 * 1024 * 1024;
+    mStats = {};
+    mLruHead = nullptr;
+    mLruTail = nullptr;
+    mQuit = false;
+    mUploadNext = 0;
+    mDrawingFrame = 0;
+    mRecordingFrame = 0;
+}
+
+TextureLoader::~TextureLoader() {
+    Shutdown();
+}
+
+bool TextureLoader::Initialize(SDL_Renderer* renderer, int decodeThreads) {
+    mRenderer = renderer;
+    mPlaceholder = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 1, 1);
+    if (!mPlaceholder) {
+        SDL_Log("Failed to create placeholder texture: %s", SDL_GetError());
+        return false;
+    }
+    Uint32 transparent = 0;
+    SDL_UpdateTexture(mPlaceholder, nullptr, &transparent, sizeof(transparent));
+    SDL_SetTextureBlendMode(mPlaceholder, SDL_BLENDMODE_BLEND);
+
+    mQuit = false;
+    for (int i = 0; i < (decodeThreads > 0 ? decodeThreads : 1); i++) {
+        mWorkers.emplace_back(&TextureLoader::WorkerMain, this);
+    }
+    return true;
+}
+
+void TextureLoader::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mQueueMutex);
+        mQuit = true;
+        mDecodeQueue.clear();
+    }
+    mQueueReady.notify_all();
+    for (std::thread& worker : mWorkers) {
+        worker.join();
+    }
+    mWorkers.clear();
+
+    // surfaces that were decoded but never uploaded, and textures that were
+    // uploaded but never handed to their asset
+    for (UploadJob& job : mDecoded) {
+        SDL_FreeSurface(job.surface);
+    }
+    mDecoded.clear();
+    for (size_t i = mUploadNext; i < mUploading.size(); i++) {
+        SDL_FreeSurface(mUploading[i].surface);
+    }
+    mUploading.clear();
+    mUploadNext = 0;
+    for (UploadedTexture& uploaded : mUploaded) {
+        SDL_DestroyTexture(uploaded.texture);
+    }
+    mUploaded.clear();
+    DestroyRetired(true);
+
+    for (auto& entry : mAssets) {
+        if (entry.second->refCount > 0) {
+            SDL_Log("Texture %s is still referenced at shutdown", entry.second->fileName.c_str());
+        }
+        if (entry.second->texture != mPlaceholder) {
+            SDL_DestroyTexture(entry.second->texture);
+        }
+        delete entry.second;
+    }
+    mAssets.clear();
+    mLruHead = nullptr;
+    mLruTail = nullptr;
+    mPending = 0;
+    mStats = {};
+    if (mPlaceholder) {
+        SDL_DestroyTexture(mPlaceholder);
+        mPlaceholder = nullptr;
+    }
+}
+
+TextureHandle TextureLoader::Request(AssetId id, const char* fileName) {
+    auto pos = mAssets.find(id);
+    if (pos != mAssets.end()) { // if found
+        TextureAsset* asset = pos->second;
+        if (asset->fileName != fileName) {
+            SDL_Log("Asset id collision between %s and %s", asset->fileName.c_str(), fileName);
+        }
+        mStats.hits++;
+        // referenced again, so it can't be evicted anymore
+        if (asset->inLru) {
+            LruUnlink(asset);
+        }
+        return TextureHandle(asset);
+    }
+
+    mStats.misses++;
+    TextureAsset* asset = new TextureAsset{id, fileName, mPlaceholder, 1, 1, false, false, this, 0, 0,
+                                           nullptr, nullptr, false};
+    mAssets.emplace(id, asset);
+
+    mPending++;
+    const PackEntry* entry = mPack ? mPack->Find(id) : nullptr;
+    if (entry) {
+        // no decode: Upload creates the texture from the mapped pixels
+        {
+            std::lock_guard<std::mutex> lock(mDecodedMutex);
+            mDecoded.push_back({asset, nullptr, mPack, entry});
+        }
+        mDecodedReady.notify_one();
+    } else {
+        QueueDecode(asset);
+    }
+    return TextureHandle(asset);
+}
+
+void TextureLoader::QueueDecode(TextureAsset* asset) {
+    {
+        std::lock_guard<std::mutex> lock(mQueueMutex);
+        mDecodeQueue.push_back(asset);
+    }
+    mQueueReady.notify_one();
+}
+
+void TextureLoader::MountPack(const AssetPack* pack) {
+    // entries of the old pack that haven't been created yet
+    std::vector<TextureAsset*> orphans;
+    {
+        std::lock_guard<std::mutex> lock(mDecodedMutex);
+        size_t kept = 0;
+        for (UploadJob& job : mDecoded) {
+            if (job.entry && job.pack != pack) {
+                orphans.push_back(job.asset);
+            } else {
+                mDecoded[kept++] = job;
+            }
+        }
+        mDecoded.resize(kept);
+    }
+    for (size_t i = mUploadNext; i < mUploading.size(); i++) {
+        if (mUploading[i].entry && mUploading[i].pack != pack) {
+            // no surface to free: it's skipped like an empty job
+            orphans.push_back(mUploading[i].asset);
+            mUploading[i].asset = nullptr;
+        }
+    }
+    for (TextureAsset* asset : orphans) {
+        QueueDecode(asset);
+    }
+    mPack = pack;
+}
+
+void TextureLoader::WorkerMain() {
+    while (true) {
+        TextureAsset* asset;
+        {
+            std::unique_lock<std::mutex> lock(mQueueMutex);
+            mQueueReady.wait(lock, [this] { return mQuit || !mDecodeQueue.empty(); });
+            if (mQuit) {
+                return;
+            }
+            asset = mDecodeQueue.front();
+            mDecodeQueue.pop_front();
+        }
+        // the slow part: file read + PNG decode, off the main thread
+        // (fileName is never modified after Request, so reading it here is safe)
+        SDL_Surface* surf = IMG_Load(asset->fileName.c_str());
+        {
+            std::lock_guard<std::mutex> lock(mDecodedMutex);
+            mDecoded.push_back({asset, surf, nullptr, nullptr});
+        }
+        mDecodedReady.notify_one();
+    }
+}
+
+void TextureLoader::UploadOne(const UploadJob& job) {
+    // (only reads the asset's file name, which never changes)
+    TextureAsset* asset = job.asset;
+    UploadedTexture uploaded = {asset, nullptr, 1, 1, 0};
+    if (job.entry) {
+        uploaded.texture = job.pack->CreateTexture(mRenderer, *job.entry);
+        if (!uploaded.texture) {
+            // fall back to the loose file
+            QueueDecode(asset);
+            return;
+        }
+        uploaded.width = static_cast<int>(job.entry->width);
+        uploaded.height = static_cast<int>(job.entry->height);
+        uploaded.bytes = static_cast<size_t>(job.entry->pitch) * job.entry->height;
+    } else if (!job.surface) {
+        SDL_Log("Failed to load texture file %s", asset->fileName.c_str());
+    } else {
+        uploaded.texture = SDL_CreateTextureFromSurface(mRenderer, job.surface);
+        SDL_FreeSurface(job.surface);
+        if (!uploaded.texture) {
+            SDL_Log("Failed to convert surface to texture for %s", asset->fileName.c_str());
+        } else {
+            Uint32 format;
+            SDL_QueryTexture(uploaded.texture, &format, nullptr, &uploaded.width, &uploaded.height);
+            uploaded.bytes = static_cast<size_t>(uploaded.width) * uploaded.height * SDL_BYTESPERPIXEL(format);
+        }
+    }
+    std::lock_guard<std::mutex> lock(mDecodedMutex);
+    mUploaded.push_back(uploaded);
+}
+
+void TextureLoader::ApplyUploads() {
+    {
+        std::lock_guard<std::mutex> lock(mDecodedMutex);
+        mApplying.swap(mUploaded);
+    }
+    if (mApplying.empty()) {
+        return;
+    }
+    for (UploadedTexture& uploaded : mApplying) {
+        TextureAsset* asset = uploaded.asset;
+        mPending--;
+        if (uploaded.texture) {
+            asset->texture = uploaded.texture;
+            asset->width = uploaded.width;
+            asset->height = uploaded.height;
+            asset->bytes = uploaded.bytes;
+            mStats.residentBytes += asset->bytes;
+            asset->ready = true;
+        } else {
+            asset->failed = true;
+        }
+        // nobody wanted it while it was loading: it starts out evictable
+        if (asset->refCount == 0) {
+            LruPushBack(asset);
+        }
+    }
+    mApplying.clear();
+    Evict();
+}
+
+void TextureLoader::DestroyRetired(bool all) {
+    std::lock_guard<std::mutex> lock(mDecodedMutex);
+    size_t kept = 0;
+    for (RetiredTexture& retired : mRetired) {
+        if (all || retired.frame <= mDrawingFrame) {
+            SDL_DestroyTexture(retired.texture);
+        } else {
+            mRetired[kept++] = retired;
+        }
+    }
+    mRetired.resize(kept);
+}
+
+void TextureLoader::Release(TextureAsset* asset) {
+    // a load in flight still owns the asset, it goes to the LRU once uploaded
+    if (asset->ready || asset->failed) {
+        LruPushBack(asset);
+        Evict();
+    }
+}
+
+void TextureLoader::SetBudget(size_t bytes) {
+    mBudget = bytes;
+    Evict();
+}
+
+void TextureLoader::LruUnlink(TextureAsset* asset) {
+    if (asset->lruPrev) {
+        asset->lruPrev->lruNext = asset->lruNext;
+    } else {
+        mLruHead = asset->lruNext;
+    }
+    if (asset->lruNext) {
+        asset->lruNext->lruPrev = asset->lruPrev;
+    } else {
+        mLruTail = asset->lruPrev;
+    }
+    asset->lruPrev = nullptr;
+    asset->lruNext = nullptr;
+    asset->inLru = false;
+}
+
+void TextureLoader::LruPushBack(TextureAsset* asset) {
+    asset->lruPrev = mLruTail;
+    asset->lruNext = nullptr;
+    if (mLruTail) {
+        mLruTail->lruNext = asset;
+    } else {
+        mLruHead = asset;
+    }
+    mLruTail = asset;
+    asset->inLru = true;
+}
+
+void TextureLoader::Clear() {
+    // the LRU list holds exactly the unreferenced, loaded textures
+    size_t budget = mBudget;
+    mBudget = 0;
+    Evict();
+    mBudget = budget;
+}
+
+void TextureLoader::Evict() {
+    // only unreferenced textures are in the list, so in-use ones always stay
+    while (mStats.residentBytes > mBudget && mLruHead) {
+        TextureAsset* asset = mLruHead;
+        LruUnlink(asset);
+        if (asset->texture != mPlaceholder) {
+            // destroyed by Upload, once no frame that's still drawn can use it
+            std::lock_guard<std::mutex> lock(mDecodedMutex);
+            mRetired.push_back({asset->texture, mRecordingFrame});
+        }
+        mStats.residentBytes -= asset->bytes;
+        mStats.evictions++;
+        mAssets.erase(asset->id);
+        delete asset;
+    }
+}
+
+int TextureLoader::Upload(float budgetMs) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    Uint64 budget = static_cast<Uint64>(budgetMs / 1000.0f * SDL_GetPerformanceFrequency());
+    DestroyRetired(false);
+    int uploaded = 0;
+    while (true) {
+        if (mUploadNext == mUploading.size()) {
+            // take everything decoded so far in one lock
+            mUploading.clear();
+            mUploadNext = 0;
+            std::lock_guard<std::mutex> lock(mDecodedMutex);
+            mUploading.swap(mDecoded);
+            if (mUploading.empty()) {
+                break;
+            }
+        }
+        // always upload at least one so a tiny budget still makes progress
+        if (uploaded > 0 && SDL_GetPerformanceCounter() - start >= budget) {
+            break;
+        }
+        // (MountPack clears the asset of a job it moved back to decoding)
+        if (mUploading[mUploadNext].asset) {
+            UploadOne(mUploading[mUploadNext]);
+            uploaded++;
+        }
+        mUploadNext++;
+    }
+    if (!mRenderThread) {
+        ApplyUploads();
+        DestroyRetired(false);
+    }
+    return uploaded;
+}
+
+void TextureLoader::Finish() {
+    while (mPending > 0) {
+        {
+            // sleep until a worker hands over another surface (or there's
+            // something left from an earlier Upload)
+            std::unique_lock<std::mutex> lock(mDecodedMutex);
+            mDecodedReady.wait(lock, [this] {
+                return !mDecoded.empty() || mUploadNext < mUploading.size() || !mUploaded.empty();
+            });
+        }
+        Upload(1000.0f);
+        ApplyUploads();
+    }
+}
@@ -0,0 +1,206 @@
+#pragma once
+#include "SDL/SDL.h"
+#include <condition_variable>
+#include <stdint.h>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Asset IDs are the FNV-1a hash of the file name. It's constexpr, so an ID
+// for a known file can be computed once (or at compile time) and looked up
+// without building a string.
+typedef uint64_t AssetId;
+constexpr AssetId HashAssetName(const char* name, AssetId hash = 14695981039346656037ull) {
+    return *name ? HashAssetName(name + 1, (hash ^ static_cast<unsigned char>(*name)) * 1099511628211ull) : hash;
+}
+
+// A texture that may still be loading. Until the image is uploaded texture is
+// a 1x1 transparent placeholder (so sprites using it simply don't show yet).
+// Kept alive by TextureHandles; once none is left it may be evicted.
+struct TextureAsset {
+    AssetId id;
+    std::string fileName;
+    SDL_Texture* texture;
+    int width;
+    int height;
+    // set on the requesting thread once the real texture replaced the placeholder
+    bool ready;
+    bool failed;
+    // Cache bookkeeping (requesting thread only)
+    class TextureLoader* loader;
+    int refCount;
+    size_t bytes; // width * height * bytes per pixel once uploaded
+    // unreferenced assets form the LRU list (oldest first)
+    TextureAsset* lruPrev;
+    TextureAsset* lruNext;
+    bool inLru;
+};
+
+// Counted reference to a TextureAsset: while any handle exists the texture is
+// never evicted. All handles must be gone before the loader shuts down.
+class TextureHandle {
+public:
+    TextureHandle() : mAsset(nullptr) {}
+    explicit TextureHandle(TextureAsset* asset);
+    TextureHandle(const TextureHandle& other);
+    TextureHandle(TextureHandle&& other) noexcept : mAsset(other.mAsset) { other.mAsset = nullptr; }
+    TextureHandle& operator=(TextureHandle other) noexcept {
+        std::swap(mAsset, other.mAsset);
+        return *this;
+    }
+    ~TextureHandle() { Reset(); }
+    void Reset();
+
+    const TextureAsset* Get() const { return mAsset; }
+    const TextureAsset* operator->() const { return mAsset; }
+    explicit operator bool() const { return mAsset != nullptr; }
+
+private:
+    TextureAsset* mAsset;
+};
+
+// Cache counters since Initialize
+struct TextureCacheStats {
+    int hits;      // Request found the asset (loaded or still loading)
+    int misses;    // Request had to start a load
+    int evictions; // unreferenced textures destroyed to stay under budget
+    size_t residentBytes;
+};
+
+// Streams textures in the background: worker threads decode files to surfaces
+// (IMG_Load) in parallel, the main thread only turns decoded surfaces into
+// textures, a few per frame under a time budget (SDL renderers must only be
+// used from the thread that created them).
+// It is also the texture cache: assets are found by AssetId, and unreferenced
+// textures are evicted least recently used first once the resident bytes go
+// over the budget.
+// With SetRenderThread the renderer's thread only runs Upload, which creates
+// and destroys textures, while the cache (Request, handles, ApplyUploads,
+// Clear, SetBudget) belongs to the thread that updates the game. An evicted
+// texture may still be in a recorded frame, so it is only destroyed once the
+// render thread draws a frame recorded after the eviction.
+class TextureLoader {
+public:
+    TextureLoader();
+    ~TextureLoader();
+    // Creates the placeholder and starts the decode threads
+    bool Initialize(SDL_Renderer* renderer, int decodeThreads);
+    // Stops the threads and destroys every texture
+    void Shutdown();
+    // Upload runs on another thread than the cache (call before either is used)
+    void SetRenderThread(bool enabled) { mRenderThread = enabled; }
+
+    // Returns the asset right away and queues the decode the first time a file
+    // is seen (id must be HashAssetName(fileName); lookups don't allocate)
+    TextureHandle Request(AssetId id, const char* fileName);
+    TextureHandle Request(const char* fileName) { return Request(HashAssetName(fileName), fileName); }
+    // Uploads decoded images until budgetMs is used up; returns how many were uploaded
+    // (renderer's thread, once per frame). Without a render thread the assets
+    // get their textures right away, else in the next ApplyUploads.
+    int Upload(float budgetMs);
+    // Render thread mode, requesting thread: gives the textures uploaded since
+    // the last call to their assets (once per frame, before the update)
+    void ApplyUploads();
+    // Render thread mode: frames are numbered by the requesting thread as it
+    // records them; textures it evicts while recording frame n are destroyed
+    // by the first Upload after the render thread started drawing frame n
+    void SetRecordingFrame(uint64_t frame) { mRecordingFrame = frame; }
+    void SetDrawingFrame(uint64_t frame) { mDrawingFrame = frame; }
+    // Blocks until everything requested so far is uploaded (e.g. on a loading
+    // screen; both halves run on the calling thread, so not while a render
+    // thread is running)
+    void Finish();
+    // Requested files that aren't uploaded yet
+    int GetPendingCount() const { return mPending; }
+
+    // Files found in a mounted pack are created straight from its mapped pixels
+    // by the next Upload (no decode); others still stream from loose files.
+    // The pack must stay open while it is mounted. Not while Upload runs on
+    // another thread (textures still waiting for the old pack are loaded from
+    // their files instead).
+    void MountPack(const class AssetPack* pack);
+
+    // Bytes of texture memory unreferenced textures may keep resident
+    void SetBudget(size_t bytes);
+    // Destroys every unreferenced texture now (e.g. once a level's actors are
+    // gone); loads still in flight join the cache when they are uploaded.
+    // The threads keep running, unlike Shutdown.
+    void Clear();
+    size_t GetBudget() const { return mBudget; }
+    const TextureCacheStats& GetStats() const { return mStats; }
+
+private:
+    friend class TextureHandle;
+    // Called by TextureHandle when the last reference goes away
+    void Release(TextureAsset* asset);
+    void LruUnlink(TextureAsset* asset);
+    void LruPushBack(TextureAsset* asset);
+    // Evicts unreferenced textures, oldest first, until under budget
+    void Evict();
+
+    // Work for Upload: a decoded surface (nullptr if the decode failed) or a
+    // pack entry to create the texture from
+    struct UploadJob {
+        TextureAsset* asset;
+        SDL_Surface* surface;
+        const class AssetPack* pack;
+        const struct PackEntry* entry;
+    };
+    // What Upload made for an asset (nullptr texture: the load failed)
+    struct UploadedTexture {
+        TextureAsset* asset;
+        SDL_Texture* texture;
+        int width;
+        int height;
+        size_t bytes;
+    };
+    // An evicted texture and the frame being recorded when it was evicted
+    struct RetiredTexture {
+        SDL_Texture* texture;
+        uint64_t frame;
+    };
+
+    void WorkerMain();
+    void QueueDecode(TextureAsset* asset);
+    void UploadOne(const UploadJob& job);
+    // Destroys the retired textures no frame that's still drawn can use
+    void DestroyRetired(bool all);
+
+    SDL_Renderer* mRenderer;
+    SDL_Texture* mPlaceholder;
+    const class AssetPack* mPack;
+    bool mRenderThread;
+    std::unordered_map<AssetId, TextureAsset*> mAssets;
+    int mPending;
+    size_t mBudget;
+    TextureCacheStats mStats;
+    TextureAsset* mLruHead;
+    TextureAsset* mLruTail;
+
+    // files waiting for a decode thread
+    std::mutex mQueueMutex;
+    std::condition_variable mQueueReady;
+    std::deque<TextureAsset*> mDecodeQueue;
+    bool mQuit;
+    // between the threads, under mDecodedMutex: decoded surfaces and pack
+    // entries waiting for Upload, textures waiting for ApplyUploads, and
+    // evicted textures waiting to be destroyed
+    std::mutex mDecodedMutex;
+    std::condition_variable mDecodedReady;
+    std::vector<UploadJob> mDecoded;
+    std::vector<UploadedTexture> mUploaded;
+    std::vector<RetiredTexture> mRetired;
+    // swapped with mDecoded so uploads happen outside the lock (Upload's thread)
+    std::vector<UploadJob> mUploading;
+    size_t mUploadNext;
+    uint64_t mDrawingFrame;
+    // swapped with mUploaded (requesting thread)
+    std::vector<UploadedTexture> mApplying;
+    uint64_t mRecordingFrame;
+
+    std::vector<std::thread> mWorkers;
+};
@@ -0,0 +1,131 @@
+#include "SpriteBatcher.h"
+#include "TileLayer.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Scrolls a 1000x200-tile level across a 1024x700 view on SDL's software
+// renderer: every tile as its own sprite (immediate, then culled and batched
+// like the draw list does it) vs. a TileLayer of baked chunks, plus the chunk
+// layer with one tile edited per frame.
+const int levelWidth = 1000;
+const int levelHeight = 200;
+const int tileSize = 32;
+const int viewWidth = 1024;
+const int viewHeight = 700;
+const int benchFrames = 120;
+// camera speed, pixels per frame
+const int scrollSpeed = 24;
+
+int main(int argc, char** argv) {
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, viewWidth, viewHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!target) {
+        SDL_Log("Failed to create surface: %s", SDL_GetError());
+        return 1;
+    }
+    SDL_Renderer* renderer = SDL_CreateSoftwareRenderer(target);
+    if (!renderer) {
+        SDL_Log("Failed to create software renderer: %s", SDL_GetError());
+        return 1;
+    }
+
+    // 8x8 tiles of different colors
+    SDL_Surface* tilesetSurface =
+        SDL_CreateRGBSurfaceWithFormat(0, 8 * tileSize, 8 * tileSize, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!tilesetSurface) {
+        SDL_Log("Failed to create tileset: %s", SDL_GetError());
+        return 1;
+    }
+    for (int i = 0; i < 64; i++) {
+        SDL_Rect rect = {(i % 8) * tileSize, (i / 8) * tileSize, tileSize, tileSize};
+        SDL_FillRect(tilesetSurface, &rect, SDL_MapRGBA(tilesetSurface->format, 4 * i, 255 - 3 * i, 60, 255));
+    }
+    SDL_Texture* tileset = SDL_CreateTextureFromSurface(renderer, tilesetSurface);
+    SDL_FreeSurface(tilesetSurface);
+    if (!tileset) {
+        SDL_Log("Failed to create tileset texture: %s", SDL_GetError());
+        return 1;
+    }
+    SDL_Rect tilesetRegion = {0, 0, 8 * tileSize, 8 * tileSize};
+
+    // a level that's a quarter empty
+    srand(42);
+    TileLayer layer(tileSize);
+    layer.SetTileset(tileset, tilesetRegion);
+    layer.SetSize(levelWidth, levelHeight);
+    int tileCount = 0;
+    for (int y = 0; y < levelHeight; y++) {
+        for (int x = 0; x < levelWidth; x++) {
+            if (rand() % 4 != 0) {
+                layer.SetTile(x, y, rand() % 64);
+                tileCount++;
+            }
+        }
+    }
+
+    // the camera pans right and drifts down and back up over the level
+    auto cameraAt = [](int frame) {
+        Vector2 camera;
+        camera.x = static_cast<float>((frame * scrollSpeed) % (levelWidth * tileSize - viewWidth));
+        camera.y = static_cast<float>((frame * 7) % (levelHeight * tileSize - viewHeight));
+        return camera;
+    };
+
+    printf("%dx%d tiles (%d non-empty), %d frames\n", levelWidth, levelHeight, tileCount, benchFrames);
+    printf("%24s %12s %12s %12s\n", "mode", "ms/frame", "draws/frame", "bakes/frame");
+    SpriteBatcher batcher;
+    for (int mode = 0; mode < 4; mode++) {
+        const char* names[] = {"sprite per tile", "culled batched sprites", "baked chunks", "chunks + 1 edit/frame"};
+        batcher.SetImmediate(mode == 0);
+        layer.ReleaseChunks();
+        long draws = 0;
+        long bakes = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < benchFrames; frame++) {
+            Vector2 camera = cameraAt(frame);
+            SDL_Rect view = {static_cast<int>(camera.x), static_cast<int>(camera.y), viewWidth, viewHeight};
+            SDL_RenderClear(renderer);
+            if (mode < 2) {
+                // what one SpriteComponent per tile would submit
+                for (int y = 0; y < levelHeight; y++) {
+                    for (int x = 0; x < levelWidth; x++) {
+                        int tile = layer.GetTile(x, y);
+                        if (tile < 0) {
+                            continue;
+                        }
+                        SDL_Rect dst = {x * tileSize, y * tileSize, tileSize, tileSize};
+                        if (mode == 1 && !SDL_HasIntersection(&dst, &view)) {
+                            continue;
+                        }
+                        dst.x -= view.x;
+                        dst.y -= view.y;
+                        SDL_Rect src = {(tile % 8) * tileSize, (tile / 8) * tileSize, tileSize, tileSize};
+                        batcher.AddSprite(tileset, tilesetRegion.w, tilesetRegion.h, src, dst, 0.0f);
+                    }
+                }
+                batcher.Flush(renderer);
+                draws += batcher.GetStats().drawCalls;
+            } else {
+                if (mode == 3) {
+                    // something on screen changes (a broken block, a switch)
+                    int x = (view.x + viewWidth / 2) / tileSize;
+                    int y = (view.y + viewHeight / 2) / tileSize;
+                    layer.SetTile(x, y, (layer.GetTile(x, y) + 1) % 64);
+                }
+                layer.Draw(renderer, camera, viewWidth, viewHeight);
+                draws += layer.GetStats().chunksDrawn;
+                bakes += layer.GetStats().chunksBaked;
+            }
+            SDL_RenderPresent(renderer);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printf("%24s %12.3f %12.1f %12.2f\n", names[mode], seconds * 1000.0 / benchFrames,
+               static_cast<double>(draws) / benchFrames, static_cast<double>(bakes) / benchFrames);
+    }
+
+    layer.ReleaseChunks();
+    SDL_DestroyTexture(tileset);
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    return 0;
+}
@@ -0,0 +1,248 @@
+#include "TileLayer.h"
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+TileLayer::TileLayer(int tileSize, int chunkTiles, int maxBakedChunks) {
+    mTileSize = tileSize;
+    mChunkTiles = chunkTiles;
+    mMaxBakedChunks = maxBakedChunks;
+    mWidth = 0;
+    mHeight = 0;
+    mChunksX = 0;
+    mChunksY = 0;
+    mTileset = nullptr;
+    mTilesetRegion = {0, 0, 0, 0};
+    mTilesetColumns = 1;
+    mParallax = 1.0f;
+    mFrame = 0;
+    mStats = {0, 0};
+}
+
+TileLayer::~TileLayer() {
+    ReleaseChunks();
+}
+
+void TileLayer::SetTileset(SDL_Texture* texture, const SDL_Rect& region) {
+    mTileset = texture;
+    mTilesetRegion = region;
+    mTilesetColumns = std::max(1, region.w / mTileSize);
+    // every chunk was baked with the old tiles
+    for (Chunk& chunk : mChunks) {
+        chunk.dirty = true;
+    }
+}
+
+bool TileLayer::Load(const char* fileName) {
+    FILE* file = fopen(fileName, "rb");
+    if (!file) {
+        SDL_Log("Failed to open tile map %s", fileName);
+        return false;
+    }
+    std::string text;
+    char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        text.append(buffer, read);
+    }
+    fclose(file);
+
+    // parse row by row; the widest row sets the map width
+    std::vector<std::vector<short>> rows;
+    const char* cursor = text.c_str();
+    while (*cursor) {
+        std::vector<short> row;
+        while (*cursor && *cursor != '\n') {
+            char* end;
+            long tile = strtol(cursor, &end, 10);
+            if (end == cursor) {
+                // separator (',' or whitespace)
+                cursor++;
+                continue;
+            }
+            row.push_back(static_cast<short>(tile));
+            cursor = end;
+        }
+        if (*cursor == '\n') {
+            cursor++;
+        }
+        if (!row.empty()) {
+            rows.push_back(std::move(row));
+        }
+    }
+    if (rows.empty()) {
+        SDL_Log("Tile map %s has no tiles", fileName);
+        return false;
+    }
+
+    size_t width = 0;
+    for (const auto& row : rows) {
+        width = std::max(width, row.size());
+    }
+    SetSize(static_cast<int>(width), static_cast<int>(rows.size()));
+    for (size_t y = 0; y < rows.size(); y++) {
+        std::copy(rows[y].begin(), rows[y].end(), mTiles.begin() + y * width);
+    }
+    return true;
+}
+
+void TileLayer::SetSize(int width, int height) {
+    ReleaseChunks();
+    mWidth = width;
+    mHeight = height;
+    mTiles.assign(static_cast<size_t>(width) * height, -1);
+    mChunksX = (width + mChunkTiles - 1) / mChunkTiles;
+    mChunksY = (height + mChunkTiles - 1) / mChunkTiles;
+    mChunks.assign(static_cast<size_t>(mChunksX) * mChunksY, {nullptr, true, 0});
+}
+
+int TileLayer::GetTile(int x, int y) const {
+    if (x < 0 || y < 0 || x >= mWidth || y >= mHeight) {
+        return -1;
+    }
+    return mTiles[static_cast<size_t>(y) * mWidth + x];
+}
+
+void TileLayer::SetTile(int x, int y, int tile) {
+    if (x < 0 || y < 0 || x >= mWidth || y >= mHeight) {
+        return;
+    }
+    short& current = mTiles[static_cast<size_t>(y) * mWidth + x];
+    if (current != tile) {
+        current = static_cast<short>(tile);
+        mChunks[(y / mChunkTiles) * mChunksX + x / mChunkTiles].dirty = true;
+    }
+}
+
+void TileLayer::Draw(SDL_Renderer* renderer, const Vector2& camera, int viewWidth, int viewHeight) {
+    mFrame++;
+    mStats = {0, 0};
+    if (!mTileset || mChunks.empty()) {
+        return;
+    }
+
+    // the view in layer space, and the chunks it overlaps
+    int chunkPixels = mChunkTiles * mTileSize;
+    int viewX = static_cast<int>(camera.x * mParallax);
+    int viewY = static_cast<int>(camera.y * mParallax);
+    int firstX = std::max(0, viewX >= 0 ? viewX / chunkPixels : -1);
+    int firstY = std::max(0, viewY >= 0 ? viewY / chunkPixels : -1);
+    int lastX = std::min(mChunksX - 1, (viewX + viewWidth - 1) / chunkPixels);
+    int lastY = std::min(mChunksY - 1, (viewY + viewHeight - 1) / chunkPixels);
+
+    for (int chunkY = firstY; chunkY <= lastY; chunkY++) {
+        for (int chunkX = firstX; chunkX <= lastX; chunkX++) {
+            int index = chunkY * mChunksX + chunkX;
+            Chunk& chunk = mChunks[index];
+            chunk.lastDrawn = mFrame;
+            int originX = chunkX * chunkPixels - viewX;
+            int originY = chunkY * chunkPixels - viewY;
+            if ((!chunk.texture || chunk.dirty) && !Bake(renderer, index)) {
+                // no render target: this chunk costs a draw per tile
+                DrawTiles(renderer, chunkX, chunkY, originX, originY);
+                continue;
+            }
+            SDL_Rect dst = {originX, originY, chunkPixels, chunkPixels};
+            SDL_RenderCopy(renderer, chunk.texture, nullptr, &dst);
+            mStats.chunksDrawn++;
+        }
+    }
+}
+
+void TileLayer::ReleaseChunks() {
+    for (int index : mBakedChunks) {
+        SDL_DestroyTexture(mChunks[index].texture);
+        mChunks[index].texture = nullptr;
+        mChunks[index].dirty = true;
+    }
+    mBakedChunks.clear();
+}
+
+bool TileLayer::Bake(SDL_Renderer* renderer, int chunkIndex) {
+    Chunk& chunk = mChunks[chunkIndex];
+    if (!chunk.texture) {
+        chunk.texture = AcquireTexture(renderer);
+        if (!chunk.texture) {
+            return false;
+        }
+        mBakedChunks.push_back(chunkIndex);
+    }
+
+    // render into the chunk, then put back whatever target was set
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    if (SDL_SetRenderTarget(renderer, chunk.texture) != 0) {
+        SDL_Log("Failed to bake tile chunk: %s", SDL_GetError());
+        return false;
+    }
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    // tiles don't overlap, so copy their pixels (and alpha) as they are
+    SDL_BlendMode blendMode;
+    SDL_GetTextureBlendMode(mTileset, &blendMode);
+    SDL_SetTextureBlendMode(mTileset, SDL_BLENDMODE_NONE);
+    DrawTiles(renderer, chunkIndex % mChunksX, chunkIndex / mChunksX, 0, 0);
+    SDL_SetTextureBlendMode(mTileset, blendMode);
+    SDL_SetRenderTarget(renderer, previousTarget);
+
+    chunk.dirty = false;
+    mStats.chunksBaked++;
+    return true;
+}
+
+SDL_Texture* TileLayer::AcquireTexture(SDL_Renderer* renderer) {
+    if (static_cast<int>(mBakedChunks.size()) < mMaxBakedChunks) {
+        int chunkPixels = mChunkTiles * mTileSize;
+        SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                                 chunkPixels, chunkPixels);
+        if (!texture) {
+            SDL_Log("Failed to create tile chunk texture: %s", SDL_GetError());
+            return nullptr;
+        }
+        // empty tiles stay transparent over the layers behind
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        return texture;
+    }
+
+    // take the texture of the chunk drawn longest ago (not one drawn this frame)
+    size_t oldest = 0;
+    for (size_t i = 1; i < mBakedChunks.size(); i++) {
+        if (mChunks[mBakedChunks[i]].lastDrawn < mChunks[mBakedChunks[oldest]].lastDrawn) {
+            oldest = i;
+        }
+    }
+    if (mBakedChunks.empty() || mChunks[mBakedChunks[oldest]].lastDrawn == mFrame) {
+        return nullptr;
+    }
+    Chunk& victim = mChunks[mBakedChunks[oldest]];
+    SDL_Texture* texture = victim.texture;
+    victim.texture = nullptr;
+    victim.dirty = true;
+    mBakedChunks[oldest] = mBakedChunks.back();
+    mBakedChunks.pop_back();
+    return texture;
+}
+
+void TileLayer::DrawTiles(SDL_Renderer* renderer, int chunkX, int chunkY, int originX, int originY) {
+    int beginX = chunkX * mChunkTiles;
+    int beginY = chunkY * mChunkTiles;
+    int endX = std::min(mWidth, beginX + mChunkTiles);
+    int endY = std::min(mHeight, beginY + mChunkTiles);
+    for (int y = beginY; y < endY; y++) {
+        const short* row = &mTiles[static_cast<size_t>(y) * mWidth];
+        for (int x = beginX; x < endX; x++) {
+            int tile = row[x];
+            if (tile < 0) {
+                continue;
+            }
+            SDL_Rect src = {mTilesetRegion.x + (tile % mTilesetColumns) * mTileSize,
+                            mTilesetRegion.y + (tile / mTilesetColumns) * mTileSize, mTileSize, mTileSize};
+            SDL_Rect dst = {originX + (x - beginX) * mTileSize, originY + (y - beginY) * mTileSize, mTileSize,
+                            mTileSize};
+            SDL_RenderCopy(renderer, mTileset, &src, &dst);
+        }
+    }
+}
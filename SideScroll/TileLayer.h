@@ -0,0 +1,85 @@
+#pragma once
+#include "Actor.h"
+#include "SDL/SDL.h"
+#include <vector>
+
+// Draw counts for the last frame of a layer
+struct TileLayerStats {
+    int chunksDrawn; // chunk textures copied to the screen
+    int chunksBaked; // chunks (re)rendered into their texture
+};
+
+// A grid of tiles from one tileset, for static scenery. Instead of one draw
+// per tile, the grid is split into square chunks and each chunk is rendered
+// ("baked") once into a target texture; a frame then copies only the few
+// chunks under the camera. Changing a tile marks its chunk dirty, and only
+// that chunk is baked again the next time it's drawn.
+// Chunks are baked the first time they come into view, and at most
+// maxBakedChunks keep a texture (the ones out of view longest give theirs up),
+// so a large level doesn't need a texture for every chunk.
+class TileLayer {
+public:
+    TileLayer(int tileSize = 32, int chunkTiles = 16, int maxBakedChunks = 48);
+    ~TileLayer();
+
+    // Tiles are read from the region of the texture (a whole texture or an
+    // atlas region), left to right, top to bottom, tileSize pixels apart
+    void SetTileset(SDL_Texture* texture, const SDL_Rect& region);
+    // Loads a CSV tile map: one row of tile indices per line, -1 for no tile
+    bool Load(const char* fileName);
+    // Resizes the map and clears every tile
+    void SetSize(int width, int height);
+    int GetWidth() const { return mWidth; }
+    int GetHeight() const { return mHeight; }
+    // -1 outside the map or where there's no tile
+    int GetTile(int x, int y) const;
+    void SetTile(int x, int y, int tile);
+
+    // How far the layer scrolls with the camera (1 = with the world, smaller
+    // values for distant backgrounds, 0 = fixed to the screen)
+    void SetParallax(float parallax) { mParallax = parallax; }
+    float GetParallax() const { return mParallax; }
+
+    // Draws the chunks intersecting the view, baking the ones that need it.
+    // camera is the top left of the view in world space
+    void Draw(SDL_Renderer* renderer, const Vector2& camera, int viewWidth, int viewHeight);
+    const TileLayerStats& GetStats() const { return mStats; }
+    // Destroys every chunk texture (they're baked again when next drawn)
+    void ReleaseChunks();
+
+private:
+    struct Chunk {
+        SDL_Texture* texture;
+        // tiles changed since the texture was baked
+        bool dirty;
+        // frame the chunk was last drawn
+        unsigned lastDrawn;
+    };
+    // Renders a chunk's tiles into its texture (false if no texture could be had)
+    bool Bake(SDL_Renderer* renderer, int chunkIndex);
+    // A texture for a chunk: a new one while under budget, else the one of
+    // the chunk that's been out of view longest
+    SDL_Texture* AcquireTexture(SDL_Renderer* renderer);
+    // Copies a chunk's tiles straight to the current target (without a texture)
+    void DrawTiles(SDL_Renderer* renderer, int chunkX, int chunkY, int originX, int originY);
+
+    int mTileSize;
+    int mChunkTiles;
+    int mMaxBakedChunks;
+    // tile indices, row by row
+    std::vector<short> mTiles;
+    int mWidth;
+    int mHeight;
+    std::vector<Chunk> mChunks;
+    int mChunksX;
+    int mChunksY;
+    // chunks that currently hold a texture
+    std::vector<int> mBakedChunks;
+
+    SDL_Texture* mTileset;
+    SDL_Rect mTilesetRegion;
+    int mTilesetColumns;
+    float mParallax;
+    unsigned mFrame;
+    TileLayerStats mStats;
+};
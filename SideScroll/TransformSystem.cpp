@@ -0,0 +1,185 @@
+#include "TransformSystem.h"
+#include <algorithm>
+#include <string.h>
+
+TransformSystem::TransformSystem() {
+    mUsed = 0;
+    mLive = 0;
+    mUpdated = 0;
+    mChildrenChanged = false;
+}
+
+TransformSystem::~TransformSystem() {
+    for (TransformChunk* chunk : mChunks) {
+        delete chunk;
+    }
+}
+
+int TransformSystem::Create() {
+    int slot;
+    if (!mFreeSlots.empty()) {
+        slot = mFreeSlots.back();
+        mFreeSlots.pop_back();
+    } else {
+        slot = mUsed++;
+        if (slot / TransformChunk::kSize >= static_cast<int>(mChunks.size())) {
+            TransformChunk* chunk = new TransformChunk();
+            // nothing to recompute in slots that haven't been handed out
+            memset(chunk->dirty, 0, sizeof(chunk->dirty));
+            mChunks.push_back(chunk);
+        }
+    }
+    TransformChunk* chunk = GetChunk(slot);
+    int i = slot % TransformChunk::kSize;
+    chunk->position[i] = {0.0f, 0.0f};
+    chunk->rotation[i] = 0.0f;
+    chunk->scale[i] = 1.0f;
+    chunk->dirty[i] = 1;
+    chunk->trigRotation[i] = 0.0f;
+    chunk->cosine[i] = 1.0f;
+    chunk->sine[i] = 0.0f;
+    chunk->parent[i] = -1;
+    chunk->depth[i] = 0;
+    mLive++;
+    return slot;
+}
+
+void TransformSystem::Destroy(int slot) {
+    TransformChunk* chunk = GetChunk(slot);
+    int i = slot % TransformChunk::kSize;
+    if (!mChildren.empty()) {
+        // orphan the children, and leave the list if it's a child itself
+        size_t kept = 0;
+        for (int child : mChildren) {
+            TransformChunk* childChunk = GetChunk(child);
+            int c = child % TransformChunk::kSize;
+            if (childChunk->parent[c] == slot) {
+                childChunk->parent[c] = -1;
+                childChunk->dirty[c] = 1;
+            } else if (child != slot) {
+                mChildren[kept++] = child;
+            }
+        }
+        if (kept != mChildren.size()) {
+            mChildren.resize(kept);
+            mChildrenChanged = true;
+        }
+    }
+    chunk->parent[i] = -1;
+    chunk->dirty[i] = 0;
+    mFreeSlots.push_back(slot);
+    mLive--;
+}
+
+bool TransformSystem::SetParent(int slot, int parent) {
+    // walking up from the new parent must not reach the slot
+    for (int ancestor = parent; ancestor >= 0; ancestor = GetParent(ancestor)) {
+        if (ancestor == slot) {
+            return false;
+        }
+    }
+    TransformChunk* chunk = GetChunk(slot);
+    int i = slot % TransformChunk::kSize;
+    if (chunk->parent[i] < 0 && parent >= 0) {
+        mChildren.push_back(slot);
+    } else if (chunk->parent[i] >= 0 && parent < 0) {
+        mChildren.erase(std::find(mChildren.begin(), mChildren.end(), slot));
+        chunk->depth[i] = 0;
+    }
+    chunk->parent[i] = parent;
+    chunk->dirty[i] = 1;
+    mChildrenChanged = true;
+    return true;
+}
+
+void TransformSystem::SortChildren() {
+    // hierarchies are shallow, walking up from each child is cheap
+    for (int slot : mChildren) {
+        int depth = 0;
+        for (int ancestor = GetParent(slot); ancestor >= 0; ancestor = GetParent(ancestor)) {
+            depth++;
+        }
+        GetChunk(slot)->depth[slot % TransformChunk::kSize] = depth;
+    }
+    std::stable_sort(mChildren.begin(), mChildren.end(), [this](int a, int b) {
+        return GetChunk(a)->depth[a % TransformChunk::kSize] < GetChunk(b)->depth[b % TransformChunk::kSize];
+    });
+}
+
+void TransformSystem::Update() {
+    if (mChildrenChanged) {
+        SortChildren();
+        mChildrenChanged = false;
+    }
+    int updated = 0;
+    for (size_t chunkIndex = 0; chunkIndex < mChunks.size(); chunkIndex++) {
+        TransformChunk* chunk = mChunks[chunkIndex];
+        // (not std::min: binding kSize to a reference would need a definition of it)
+        int left = mUsed - static_cast<int>(chunkIndex) * TransformChunk::kSize;
+        int count = left < TransformChunk::kSize ? left : TransformChunk::kSize;
+        // skip chunks nothing moved in (an OR over the flags)
+        unsigned char any = 0;
+        for (int i = 0; i < count; i++) {
+            any |= chunk->dirty[i];
+        }
+        if (!any) {
+            continue;
+        }
+
+        // trig only where the rotation changed (most moves are translations)
+        for (int i = 0; i < count; i++) {
+            if (chunk->dirty[i] && chunk->rotation[i] != chunk->trigRotation[i]) {
+                chunk->trigRotation[i] = chunk->rotation[i];
+                chunk->cosine[i] = cosf(chunk->rotation[i]);
+                chunk->sine[i] = sinf(chunk->rotation[i]);
+            }
+        }
+
+        // world = local for every dirty slot, as selects the compiler can
+        // vectorize (children are overwritten below)
+        const unsigned char* dirty = chunk->dirty;
+        for (int i = 0; i < count; i++) {
+            bool d = dirty[i] != 0;
+            chunk->worldX[i] = d ? chunk->position[i].x : chunk->worldX[i];
+            chunk->worldY[i] = d ? chunk->position[i].y : chunk->worldY[i];
+            chunk->worldCosine[i] = d ? chunk->cosine[i] : chunk->worldCosine[i];
+            chunk->worldSine[i] = d ? chunk->sine[i] : chunk->worldSine[i];
+            chunk->worldScale[i] = d ? chunk->scale[i] : chunk->worldScale[i];
+            chunk->worldRotation[i] = d ? chunk->rotation[i] : chunk->worldRotation[i];
+            updated += d;
+        }
+    }
+
+    // children, parents first: a child is recomputed if it or its parent changed
+    for (int slot : mChildren) {
+        TransformChunk* chunk = GetChunk(slot);
+        int i = slot % TransformChunk::kSize;
+        int parent = chunk->parent[i];
+        TransformChunk* parentChunk = GetChunk(parent);
+        int p = parent % TransformChunk::kSize;
+        if (!chunk->dirty[i] && !parentChunk->dirty[p]) {
+            continue;
+        }
+        if (!chunk->dirty[i]) {
+            chunk->dirty[i] = 1;
+            updated++;
+        }
+        // rotate and scale the local offset into the parent's frame
+        float pc = parentChunk->worldCosine[p];
+        float ps = parentChunk->worldSine[p];
+        float pk = parentChunk->worldScale[p];
+        Vector2 local = chunk->position[i];
+        chunk->worldX[i] = parentChunk->worldX[p] + pk * (pc * local.x + ps * local.y);
+        chunk->worldY[i] = parentChunk->worldY[p] + pk * (pc * local.y - ps * local.x);
+        // angles add: cos(a + b), sin(a + b) without calling cos/sin
+        chunk->worldCosine[i] = pc * chunk->cosine[i] - ps * chunk->sine[i];
+        chunk->worldSine[i] = ps * chunk->cosine[i] + pc * chunk->sine[i];
+        chunk->worldScale[i] = pk * chunk->scale[i];
+        chunk->worldRotation[i] = parentChunk->worldRotation[p] + chunk->rotation[i];
+    }
+
+    for (size_t chunkIndex = 0; chunkIndex < mChunks.size(); chunkIndex++) {
+        memset(mChunks[chunkIndex]->dirty, 0, sizeof(mChunks[chunkIndex]->dirty));
+    }
+    mUpdated = updated;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "../Common/Math.h"
+#include <vector>
+
+// Transforms of one chunk of slots, each field its own array
+// (positions stay Vector2 so Actor::GetPosition can return a reference)
+struct TransformChunk {
+    static const int kSize = 1024;
+    // local transform (relative to the parent, if any)
+    Vector2 position[kSize];
+    float rotation[kSize];
+    float scale[kSize];
+    // set by the setters, cleared by TransformSystem::Update
+    unsigned char dirty[kSize];
+    // cosine/sine of rotation, recomputed only when rotation changes
+    float trigRotation[kSize];
+    float cosine[kSize];
+    float sine[kSize];
+    // world transform (uniform scale, so the rotation's cosine/sine, the
+    // scale and the translation describe it)
+    float worldX[kSize];
+    float worldY[kSize];
+    float worldCosine[kSize];
+    float worldSine[kSize];
+    float worldScale[kSize];
+    float worldRotation[kSize];
+    // parent slot (-1 for none) and how deep the slot is in its hierarchy
+    int parent[kSize];
+    int depth[kSize];
+};
+
+// Local and world transforms of every actor, in chunks that never move (so
+// references stay valid). Setting a local transform only marks the slot
+// dirty; Update then recomputes the world transforms of dirty slots in one
+// pass: chunks without a dirty slot are skipped, sine/cosine are recomputed
+// only when the rotation actually changed, and the world values are filled in
+// a branch-free loop over the chunk's arrays. Slots with a parent are done
+// after that, parents before children, as parentWorld * local.
+// Setters only write their own slot, so actors may be moved from parallel
+// component updates (transform reads/writes are declared as kDataTransform).
+class TransformSystem {
+public:
+    TransformSystem();
+    ~TransformSystem();
+    TransformSystem(const TransformSystem&) = delete;
+    TransformSystem& operator=(const TransformSystem&) = delete;
+
+    // Identity transform, dirty (freed slots are reused)
+    int Create();
+    // Children of the slot lose their parent (keeping their local transform)
+    void Destroy(int slot);
+    TransformChunk* GetChunk(int slot) const { return mChunks[slot / TransformChunk::kSize]; }
+
+    // parent -1 detaches; fails (returns false) if it would make a cycle
+    bool SetParent(int slot, int parent);
+    int GetParent(int slot) const { return GetChunk(slot)->parent[slot % TransformChunk::kSize]; }
+
+    // Recomputes the world transform of every dirty slot (and their children)
+    void Update();
+    int GetLiveCount() const { return mLive; }
+    // Slots recomputed by the last Update
+    int GetUpdatedCount() const { return mUpdated; }
+
+private:
+    // Re-derives the depths of mChildren after the hierarchy changed and sorts it
+    void SortChildren();
+
+    std::vector<TransformChunk*> mChunks;
+    std::vector<int> mFreeSlots;
+    int mUsed;
+    int mLive;
+    int mUpdated;
+    // slots that have a parent, shallowest first (re-sorted by the next Update
+    // once the hierarchy changed)
+    std::vector<int> mChildren;
+    bool mChildrenChanged;
+};